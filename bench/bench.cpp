@@ -0,0 +1,486 @@
+/**
+ * @file bench.cpp
+ * @brief Microbenchmarks of the engine's hot paths, reported as JSON.
+ *
+ * Usage: bench [options]
+ *   --filter TEXT    Only run benchmarks whose name contains TEXT.
+ *   --samples N      Timed samples per benchmark (default 7).
+ *   --sample-ms N    Target duration of each sample in milliseconds (default 50).
+ *   -o, --out FILE   Write the JSON report to FILE instead of stdout.
+ *
+ * Each benchmark is first calibrated to find how many iterations fill a sample,
+ * then timed over every sample. The report holds, per benchmark, the iterations
+ * per sample and the minimum, median, mean and standard deviation of nanoseconds
+ * per iteration; compare the median (or minimum on noisy machines) between builds.
+ */
+
+#include "slt.hpp"
+#include "solver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace solitaire;
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    /// @brief Keeps the compiler from optimizing away the computation of value.
+    template <typename T>
+    inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static const volatile void *sink;
+        sink = &value;
+#endif
+    }
+
+    struct Options {
+        std::string filter;
+        std::size_t samples = 7;
+        std::chrono::milliseconds sampleTime {50};
+        std::string output; // empty for stdout
+    };
+
+    struct Benchmark {
+        const char *name;
+        // runs the measured operation the given number of times
+        std::function<void(std::uint64_t)> run;
+    };
+
+    struct Report {
+        std::string name;
+        std::uint64_t iterations;
+        double min;
+        double median;
+        double mean;
+        double stddev;
+    };
+
+    double timeIterations(const Benchmark& benchmark, std::uint64_t iterations) {
+        auto began = clock::now();
+        benchmark.run(iterations);
+        return std::chrono::duration<double, std::nano>(clock::now() - began).count();
+    }
+
+    Report measure(const Benchmark& benchmark, const Options& options) {
+        double target = std::chrono::duration<double, std::nano>(options.sampleTime).count();
+
+        // grow the iteration count until a run takes long enough to scale from
+        std::uint64_t iterations = 1;
+        double elapsed = timeIterations(benchmark, iterations);
+        while (elapsed < target / 10 && iterations < (std::uint64_t(1) << 40)) {
+            iterations *= 2;
+            elapsed = timeIterations(benchmark, iterations);
+        }
+        iterations = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(iterations * target / std::max(elapsed, 1.0)));
+
+        std::vector<double> perIteration;
+        for (std::size_t i = 0; i < options.samples; i++) {
+            perIteration.push_back(timeIterations(benchmark, iterations) / iterations);
+        }
+        std::sort(perIteration.begin(), perIteration.end());
+
+        Report report {benchmark.name, iterations, perIteration.front(), 0, 0, 0};
+        std::size_t middle = perIteration.size() / 2;
+        report.median = perIteration.size() % 2 == 1
+            ? perIteration[middle]
+            : (perIteration[middle - 1] + perIteration[middle]) / 2;
+        for (double value : perIteration) {
+            report.mean += value / perIteration.size();
+        }
+        for (double value : perIteration) {
+            report.stddev += (value - report.mean) * (value - report.mean) / perIteration.size();
+        }
+        report.stddev = std::sqrt(report.stddev);
+        return report;
+    }
+
+    CardPile fullPile() {
+        CardPile pile;
+        for (std::size_t i = 0; i < Card::DECK_SIZE; i++) {
+            pile.add(Card::fromIndex(i));
+        }
+        return pile;
+    }
+
+    CardPile pileOf(std::size_t amount) {
+        CardPile pile;
+        for (std::size_t i = 0; i < amount; i++) {
+            pile.add(Card::fromIndex(i));
+        }
+        return pile;
+    }
+
+    /**
+     * @brief Finds the first seed whose deal has a move of the given type, and that move.
+     * Only the opening position is looked at, so the setup stays cheap and deterministic.
+     */
+    std::pair<Game, Move> findOpening(MoveType type) {
+        MoveBuffer moves;
+        for (std::minstd_rand::result_type seed = 1;; seed++) {
+            std::unique_ptr<Game> game(Game::createFromSeed(seed));
+            game->generateMoves(moves);
+            for (const Move& move : moves) {
+                if (move.type == type && move.count == 1) {
+                    return {*game, move};
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Plays random clicks and drags through the same Game calls the GUI makes,
+     * until the game is won or maxActions actions were tried.
+     * @return The number of moves the game counted.
+     */
+    template <typename URNG>
+    int playRandomlyLikeTheGui(Game& game, URNG& rand, int maxActions) {
+        std::uniform_int_distribution<int> action(0, 2);
+        std::uniform_int_distribution<std::size_t> tableau(0, NUM_TABLEAUS - 1);
+        for (int i = 0; i < maxActions && !game.isWon(); i++) {
+            switch (action(rand)) {
+                case 0:
+                    if (game.hasStock()) {
+                        game.turnStock();
+                    } else {
+                        game.returnWasteToStock();
+                    }
+                    break;
+                case 1:
+                    if (!game.hasWaste()) break;
+                    game.takeWaste();
+                    if (game.attemptHeldToFoundation().empty() && game.attemptHeldToTableau().empty()) {
+                        game.returnHeldCards();
+                    }
+                    break;
+                default: {
+                    std::size_t index = tableau(rand);
+                    std::size_t size = game.getOpenTableau(index).size();
+                    if (size == 0) break;
+                    std::size_t amount = std::uniform_int_distribution<std::size_t>(1, size)(rand);
+                    game.takeTableau(index, amount);
+                    bool placed = amount == 1 && !game.attemptHeldToFoundation().empty();
+                    if (!placed && game.attemptHeldToTableau().empty()) {
+                        game.returnHeldCards();
+                    }
+                    break;
+                }
+            }
+        }
+        return game.getMoveCount();
+    }
+
+    /**
+     * @brief Plays uniformly random legal moves from Game::generateMoves,
+     * until the game is won, no move is left or maxMoves moves were played.
+     */
+    template <typename URNG>
+    std::size_t playRandomMoves(Game& game, URNG& rand, std::size_t maxMoves) {
+        MoveBuffer moves;
+        std::size_t played = 0;
+        while (played < maxMoves && !game.isWon()) {
+            game.generateMoves(moves);
+            if (moves.empty()) break;
+            game.apply(moves[std::uniform_int_distribution<std::size_t>(0, moves.size() - 1)(rand)]);
+            played++;
+        }
+        return played;
+    }
+
+    std::vector<Benchmark> benchmarks() {
+        std::vector<Benchmark> list;
+
+        list.push_back({"cardpile/add", [](std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; i++) {
+                CardPile pile;
+                for (std::size_t c = 0; c < Card::DECK_SIZE; c++) {
+                    pile.add(Card::fromIndex(c));
+                }
+                keep(pile);
+            }
+        }});
+
+        // what CardPile::split used to do: lift the top of a pile off as a run
+        list.push_back({"cardpile/moveTopOnto", [](std::uint64_t n) {
+            CardPile source = fullPile();
+            CardPile dest;
+            for (std::uint64_t i = 0; i < n; i++) {
+                source.moveTopOnto(dest, 13);
+                dest.moveTopOnto(source, 13);
+                keep(source);
+            }
+        }});
+
+        list.push_back({"cardpile/stack", [](std::uint64_t n) {
+            const CardPile base = pileOf(20);
+            const CardPile run = pileOf(13);
+            for (std::uint64_t i = 0; i < n; i++) {
+                CardPile bottom = base;
+                CardPile top = run;
+                bottom.stack(top);
+                keep(bottom);
+            }
+        }});
+
+        list.push_back({"cardpile/turnOnto", [](std::uint64_t n) {
+            const CardPile waste = pileOf(24);
+            for (std::uint64_t i = 0; i < n; i++) {
+                CardPile from = waste;
+                CardPile stock;
+                from.turnOnto(stock);
+                keep(stock);
+            }
+        }});
+
+        list.push_back({"game/createAndDealGame", [](std::uint64_t n) {
+            std::minstd_rand rand(1);
+            for (std::uint64_t i = 0; i < n; i++) {
+                std::unique_ptr<Game> game(Game::createAndDealGame(rand));
+                keep(*game);
+            }
+        }});
+
+        list.push_back({"game/stockCycle", [](std::uint64_t n) {
+            std::unique_ptr<Game> game(Game::createFromSeed(1));
+            for (std::uint64_t i = 0; i < n; i++) {
+                while (game->hasStock()) {
+                    game->turnStock();
+                }
+                game->returnWasteToStock();
+                keep(*game);
+            }
+        }});
+
+        list.push_back({"game/tableauMove", [](std::uint64_t n) {
+            auto [start, move] = findOpening(MoveType::TABLEAU_TO_TABLEAU);
+            for (std::uint64_t i = 0; i < n; i++) {
+                Game game = start;
+                game.takeTableau(move.from, move.count);
+                game.stackTableau(move.to);
+                keep(game);
+            }
+        }});
+
+        list.push_back({"game/attemptHeldToFoundation", [](std::uint64_t n) {
+            auto [start, move] = findOpening(MoveType::TABLEAU_TO_FOUNDATION);
+            for (std::uint64_t i = 0; i < n; i++) {
+                Game game = start;
+                game.takeTableau(move.from, 1);
+                keep(game.attemptHeldToFoundation());
+            }
+        }});
+
+        list.push_back({"game/attemptHeldToTableau", [](std::uint64_t n) {
+            auto [start, move] = findOpening(MoveType::TABLEAU_TO_TABLEAU);
+            for (std::uint64_t i = 0; i < n; i++) {
+                Game game = start;
+                game.takeTableau(move.from, move.count);
+                keep(game.attemptHeldToTableau());
+            }
+        }});
+
+        list.push_back({"game/generateMoves", [](std::uint64_t n) {
+            std::unique_ptr<Game> game(Game::createFromSeed(1));
+            MoveBuffer moves;
+            for (std::uint64_t i = 0; i < n; i++) {
+                game->generateMoves(moves);
+                keep(moves);
+            }
+        }});
+
+        list.push_back({"game/applyRevert", [](std::uint64_t n) {
+            auto [game, move] = findOpening(MoveType::TABLEAU_TO_TABLEAU);
+            for (std::uint64_t i = 0; i < n; i++) {
+                game.revert(game.apply(move));
+                keep(game);
+            }
+        }});
+
+        list.push_back({"game/save", [](std::uint64_t n) {
+            std::unique_ptr<Game> game(Game::createFromSeed(1));
+            Game::SaveData data;
+            for (std::uint64_t i = 0; i < n; i++) {
+                game->save(data);
+                keep(data);
+            }
+        }});
+
+        list.push_back({"game/load", [](std::uint64_t n) {
+            std::unique_ptr<Game> game(Game::createFromSeed(1));
+            Game::SaveData data;
+            game->save(data);
+            for (std::uint64_t i = 0; i < n; i++) {
+                keep(game->load(data));
+            }
+        }});
+
+        list.push_back({"game/randomGuiGame", [](std::uint64_t n) {
+            std::minstd_rand rand(1);
+            for (std::uint64_t i = 0; i < n; i++) {
+                std::unique_ptr<Game> game(Game::createAndDealGame(rand));
+                keep(playRandomlyLikeTheGui(*game, rand, 1000));
+            }
+        }});
+
+        list.push_back({"game/randomMoveGame", [](std::uint64_t n) {
+            std::minstd_rand rand(1);
+            for (std::uint64_t i = 0; i < n; i++) {
+                std::unique_ptr<Game> game(Game::createAndDealGame(rand));
+                keep(playRandomMoves(*game, rand, 1000));
+            }
+        }});
+
+        list.push_back({"solver/solveSeed8", [](std::uint64_t n) {
+            std::unique_ptr<Game> game(Game::createFromSeed(8));
+            SolverLimits limits;
+            limits.tableBits = 16;
+            Solver solver(limits);
+            for (std::uint64_t i = 0; i < n; i++) {
+                keep(solver.solve(*game).nodes);
+            }
+        }});
+
+        // a search large enough to spread over threads, to see how it scales; 0 is one per hardware thread
+        static constexpr std::pair<const char *, unsigned> PARALLEL[] = {
+            {"solver/parallelSeed26/1", 1},
+            {"solver/parallelSeed26/2", 2},
+            {"solver/parallelSeed26/4", 4},
+            {"solver/parallelSeed26/hardware", 0},
+        };
+        for (auto [name, threads] : PARALLEL) {
+            list.push_back({name, [threads = threads](std::uint64_t n) {
+                std::unique_ptr<Game> game(Game::createFromSeed(26)); // about 270k nodes
+                SolverLimits limits;
+                limits.tableBits = 20;
+                ParallelSolver solver(limits, threads);
+                for (std::uint64_t i = 0; i < n; i++) {
+                    keep(solver.solve(*game).nodes);
+                }
+            }});
+        }
+
+        return list;
+    }
+
+    std::uint64_t parseNumber(const std::string& text, const char *what) {
+        std::size_t parsed = 0;
+        unsigned long long value = 0;
+        try {
+            value = std::stoull(text, &parsed);
+        } catch (const std::exception&) {
+            parsed = 0;
+        }
+        if (parsed == 0 || parsed != text.size()) {
+            throw std::invalid_argument(std::string("Invalid ") + what + ": " + text);
+        }
+        return value;
+    }
+
+    Options parseOptions(int argc, char **argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--filter") {
+                options.filter = value();
+            } else if (arg == "--samples") {
+                options.samples = std::max<std::uint64_t>(1, parseNumber(value(), "sample count"));
+            } else if (arg == "--sample-ms") {
+                options.sampleTime = std::chrono::milliseconds(parseNumber(value(), "sample time"));
+            } else if (arg == "-o" || arg == "--out") {
+                options.output = value();
+            } else {
+                throw std::invalid_argument("Unknown argument " + arg);
+            }
+        }
+        return options;
+    }
+
+    void writeReport(std::ostream& out, const std::vector<Report>& reports, const Options& options) {
+        char date[32] = {};
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        out << "{\n";
+        out << "  \"context\": {\n";
+        out << "    \"date\": \"" << date << "\",\n";
+#if defined(__VERSION__)
+        out << "    \"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+#if defined(NDEBUG)
+        out << "    \"assertions\": false,\n";
+#else
+        out << "    \"assertions\": true,\n";
+#endif
+        out << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "    \"parallel_max_work_items\": " << ParallelSolver::MAX_WORK_ITEMS << ",\n";
+        out << "    \"samples\": " << options.samples << ",\n";
+        out << "    \"sample_ms\": " << options.sampleTime.count() << "\n";
+        out << "  },\n";
+        out << "  \"benchmarks\": [";
+        for (std::size_t i = 0; i < reports.size(); i++) {
+            const Report& report = reports[i];
+            out << (i == 0 ? "\n" : ",\n");
+            out << "    {\"name\": \"" << report.name << "\""
+                << ", \"iterations\": " << report.iterations
+                << ", \"ns_min\": " << report.min
+                << ", \"ns_median\": " << report.median
+                << ", \"ns_mean\": " << report.mean
+                << ", \"ns_stddev\": " << report.stddev
+                << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        std::cerr << "Usage: " << argv[0] << " [--filter TEXT] [--samples N] [--sample-ms N] [-o FILE]\n";
+        return 2;
+    }
+
+    std::vector<Report> reports;
+    for (const Benchmark& benchmark : benchmarks()) {
+        if (std::string(benchmark.name).find(options.filter) == std::string::npos) continue;
+
+        reports.push_back(measure(benchmark, options));
+        std::cerr << benchmark.name << ": " << reports.back().median << " ns\n";
+    }
+
+    if (options.output.empty()) {
+        writeReport(std::cout, reports, options);
+        return std::cout ? 0 : 1;
+    }
+    std::ofstream file(options.output);
+    writeReport(file, reports, options);
+    if (!file) {
+        std::cerr << "Cannot write " << options.output << '\n';
+        return 1;
+    }
+    return 0;
+}
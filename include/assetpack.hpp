@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "mappedfile.hpp"
+
+namespace solitaire {
+    /**
+     * @brief The layout of asset pack files, written by tools/packassets.cpp.
+     *
+     * A pack holds one atlas image, already decoded, and an index of named regions in it.
+     * All integers are little-endian:
+     *   - a 32 byte header: the magic "SLTPACK\0", a u16 version, a u16 region count,
+     *     the u32 width and u32 height of the atlas, the u32 offset of its pixels from the
+     *     start of the file and 8 reserved bytes
+     *   - the index, one 32 byte entry per region: its null-padded name of at most 15
+     *     characters, then its u32 x, y, width and height in the atlas
+     *   - the pixels of the atlas, 8 bit RGBA rows without padding, starting on a 16 byte boundary
+     *
+     * A region is named after the image it came from, relative to the images directory and
+     * without its extension, e.g. "h/K" or "back/A".
+     */
+    namespace assetpack {
+        constexpr char MAGIC[8] = {'S', 'L', 'T', 'P', 'A', 'C', 'K', '\0'};
+        constexpr std::uint16_t VERSION = 1;
+        constexpr std::size_t HEADER_SIZE = 32;
+        constexpr std::size_t ENTRY_SIZE = 32;
+        constexpr std::size_t NAME_SIZE = 16;
+        constexpr std::size_t PIXELS_ALIGNMENT = 16;
+        constexpr std::size_t BYTES_PER_PIXEL = 4;
+    }
+
+    /**
+     * @brief An asset pack mapped into memory, whose atlas can be uploaded straight from the mapping.
+     */
+    class AssetPack {
+    public:
+        /// @brief A named rectangle of the atlas, in pixels.
+        struct Region {
+            std::uint32_t x;
+            std::uint32_t y;
+            std::uint32_t width;
+            std::uint32_t height;
+        };
+
+    private:
+        MappedFile file;
+        std::uint16_t regionCount = 0;
+        std::uint32_t width = 0;
+        std::uint32_t height = 0;
+        const unsigned char *pixels = nullptr;
+
+    public:
+        /**
+         * @brief Maps the pack at path and checks its header and index.
+         * @throws std::system_error If the file cannot be opened or mapped.
+         * @throws solitaire::InvalidAssetPackException If it is not a valid pack of this version.
+         */
+        explicit AssetPack(const std::string& path);
+
+        /**
+         * @brief Looks up a region by name, in time linear in the size of the index.
+         * @param name The name of the region, e.g. "h/K".
+         * @param region Receives the region if found.
+         * @return false if the pack has no region with that name.
+         */
+        bool find(const std::string& name, Region& region) const noexcept;
+
+        std::uint32_t atlasWidth() const noexcept;
+        std::uint32_t atlasHeight() const noexcept;
+
+        /// @brief Gets the RGBA pixels of the atlas, valid for as long as the pack lives.
+        const unsigned char *atlasPixels() const noexcept;
+    };
+}
@@ -1,7 +1,9 @@
 #pragma once
 
-#include <deque>
+#include <cstddef>
+#include <cstdint>
 #include <iosfwd>
+#include <iterator>
 
 
 namespace solitaire {
@@ -65,72 +67,134 @@ namespace solitaire {
 
     /**
      * @brief The representation of a Card, with a Suit and a Face.
+     * Cards are plain values packed into a single byte: the Face occupies the
+     * low 4 bits and the Suit the 2 bits above it.
      */
     class Card {
+        std::uint8_t id;
     public:
-        const Face face;
-        const Suit suit;
+        /// @brief Number of distinct cards in a full deck.
+        static constexpr std::size_t DECK_SIZE = static_cast<std::size_t>(Suit::COUNT) * static_cast<std::size_t>(Face::COUNT);
 
-        Card(Face f, Suit s) noexcept: face(f), suit(s) {}
+        constexpr Card() noexcept: id(0) {}
+        constexpr Card(Face f, Suit s) noexcept:
+            id(static_cast<std::uint8_t>(static_cast<int>(s) << 4 | static_cast<int>(f))) {}
+
+        constexpr Face face() const noexcept {
+            return static_cast<Face>(this->id & 0x0F);
+        }
+
+        constexpr Suit suit() const noexcept {
+            return static_cast<Suit>(this->id >> 4);
+        }
+
+        /**
+         * @brief Gets the dense index of this Card, in [0, DECK_SIZE).
+         * Suits are laid out in order, with faces in order inside each suit.
+         * @return std::size_t The index of the Card.
+         */
+        constexpr std::size_t index() const noexcept {
+            return static_cast<std::size_t>(this->suit()) * static_cast<std::size_t>(Face::COUNT)
+                + static_cast<std::size_t>(this->face()) - static_cast<std::size_t>(Face::FIRST);
+        }
+
+        /**
+         * @brief Builds the Card with the given dense index.
+         * @param index The index, in [0, DECK_SIZE).
+         * @return Card The Card such that Card::index() == index.
+         */
+        static constexpr Card fromIndex(std::size_t index) noexcept {
+            constexpr auto nFaces = static_cast<std::size_t>(Face::COUNT);
+            return Card(
+                static_cast<Face>(index % nFaces + static_cast<std::size_t>(Face::FIRST)),
+                static_cast<Suit>(index / nFaces)
+            );
+        }
+
+        constexpr bool operator==(const Card& other) const noexcept {
+            return this->id == other.id;
+        }
+
+        constexpr bool operator!=(const Card& other) const noexcept {
+            return this->id != other.id;
+        }
 
         friend std::ostream& operator<<(std::ostream& os, const Card& card) noexcept;
     };
 
     /**
      * @brief The representation of a stack of cards.
+     * Cards are stored inline, base first, in a fixed-capacity buffer large enough
+     * for a full deck, so piles never allocate and are trivially copyable.
      */
     class CardPile {
-        std::deque<Card *> cards;
+    public:
+        /// @brief The most cards any pile can hold.
+        static constexpr std::size_t CAPACITY = Card::DECK_SIZE;
+
+    private:
+        Card cards[CAPACITY]; // cards[0] is the base, cards[count - 1] is the top
+        std::uint8_t count = 0;
+
     public:
         /**
          * @brief Adds a Card to the top of the pile.
+         * The pile must hold fewer than CAPACITY cards.
          * @param c The Card to add.
          */
-        void add(Card *c) noexcept;
+        void add(Card c) noexcept {
+            this->cards[this->count++] = c;
+        }
 
         /**
          * @brief Checks if the pile is empty.
          * @return true If the pile is empty.
          * @return false If there are cards in the pile.
          */
-        bool empty() const noexcept;
+        bool empty() const noexcept {
+            return this->count == 0;
+        }
 
         /**
          * @brief Gets the number of cards in the pile.
          * @return std::size_t The number of cards in the pile.
          */
-        std::size_t size() const noexcept;
+        std::size_t size() const noexcept {
+            return this->count;
+        }
+
+        // iteration goes from the top of the pile to its base
 
         auto begin() noexcept {
-            return this->cards.begin();
+            return std::make_reverse_iterator(this->cards + this->count);
         }
 
         auto end() noexcept {
-            return this->cards.end();
+            return std::make_reverse_iterator(this->cards + 0);
         }
 
         auto begin() const noexcept {
-            return this->cards.cbegin();
+            return std::make_reverse_iterator(static_cast<const Card *>(this->cards + this->count));
         }
 
         auto end() const noexcept {
-            return this->cards.cend();
+            return std::make_reverse_iterator(static_cast<const Card *>(this->cards + 0));
         }
 
         auto rbegin() noexcept {
-            return this->cards.rbegin();
+            return this->cards + 0;
         }
 
         auto rend() noexcept {
-            return this->cards.rend();
+            return this->cards + this->count;
         }
 
         auto rbegin() const noexcept {
-            return this->cards.crbegin();
+            return static_cast<const Card *>(this->cards + 0);
         }
 
         auto rend() const noexcept {
-            return this->cards.crend();
+            return static_cast<const Card *>(this->cards + this->count);
         }
 
 
@@ -138,26 +202,46 @@ namespace solitaire {
          * @brief Returns the Card on an index from the top of the pile, if any.
          * @param index The position from the top of the pile to check; 0 or omitted for the top of the pile.
          * @return nullptr If there is no card at the given index.
-         * @return const Card* The non-nullptr Card * at that position of the pile.
+         * @return const Card* A pointer to the Card at that position of the pile, valid until the pile is modified.
          */
-        [[nodiscard]] const Card *peek(std::size_t index=0) const noexcept;
+        [[nodiscard]] const Card *peek(std::size_t index=0) const noexcept {
+            if (this->count > index) {
+                return &this->cards[this->count - 1 - index];
+            } else {
+                return nullptr;
+            }
+        }
 
         /**
          * @brief Returns the Card on the bottom of the pile, if any.
          * @return nullptr If the pile is empty.
-         * @return const Card* The non-nullptr Card * at the base of the pile.
+         * @return const Card* A pointer to the Card at the base of the pile, valid until the pile is modified.
+         */
+        [[nodiscard]] const Card *peekBase() const noexcept {
+            if (this->count > 0) {
+                return &this->cards[0];
+            } else {
+                return nullptr;
+            }
+        }
+
+        /**
+         * @brief Moves the amount top cards of this pile onto the top of dest, keeping their order.
+         * The cards are copied in one block, without any allocation.
+         * @param dest The pile receiving the cards.
+         * @param amount The amount of cards to move.
+         * @throws solitaire::NotEnoughCardsException If there are not enough cards in the pile.
          */
-        [[nodiscard]] const Card *peekBase() const noexcept;
+        void moveTopOnto(CardPile& dest, std::size_t amount);
 
         /**
-         * @brief Splits the pile in two, with the index range [0, amount) being returned
-         * in a new CardPile, and the remaining Cards staying put as this pile's cards.
-         * The new CardPile was allocated with new and MUST be deleted after use.
-         * @param amount The amount of cards to put in the new pile.
+         * @brief Moves the amount top cards of this pile onto the top of dest one by one,
+         * which reverses their order, like turning them over.
+         * @param dest The pile receiving the cards.
+         * @param amount The amount of cards to move.
          * @throws solitaire::NotEnoughCardsException If there are not enough cards in the pile.
-         * @return CardPile* The newly allocated pile.
          */
-        [[nodiscard]] CardPile *split(std::size_t amount);
+        void turnTopOnto(CardPile& dest, std::size_t amount);
 
         /**
          * @brief Takes all cards from newTop and moves them to the top of this pile.
@@ -167,16 +251,16 @@ namespace solitaire {
         /**
          * @brief Removes the top card of the pile and returns it.
          * @throws solitaire::NotEnoughCardsException If the pile is empty.
-         * @return Card* The removed Card.
+         * @return Card The removed Card.
          */
-        [[nodiscard]] Card *takeTop();
+        [[nodiscard]] Card takeTop();
 
         /**
          * @brief Removes the bottom card of the pile and returns it.
          * @throws solitaire::NotEnoughCardsException If the pile is empty.
-         * @return Card* The removed Card.
+         * @return Card The removed Card.
          */
-        [[nodiscard]] Card *takeBase();
+        [[nodiscard]] Card takeBase();
 
         /**
          * @brief Removes all cards from this pile and stacks them in reverse order on top of newBase.
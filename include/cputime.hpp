@@ -0,0 +1,9 @@
+#pragma once
+
+namespace solitaire {
+    /**
+     * @brief Gets the CPU time used so far by every thread of this process, user and kernel.
+     * @return The time in seconds, from an arbitrary starting point; only differences are meaningful.
+     */
+    double processCpuSeconds() noexcept;
+}
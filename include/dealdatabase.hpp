@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "mappedfile.hpp"
+#include "solver.hpp"
+
+namespace solitaire {
+    /**
+     * @brief The layout of deal database files, written by `analyze --database`.
+     *
+     * All integers are little-endian:
+     *   - a 32 byte header: the magic "SLTDEALS", a u16 version, a u16 record size, the u8 draw
+     *     count the deals were solved with, a u8 tier count, 2 reserved bytes, the u32 first seed,
+     *     the u32 number of seeds, the u32 number of winnable seeds and the u32 node limit the
+     *     solver had per seed (0 for none)
+     *   - the tier table, one u32 per tier: where the tier starts in the winnable list, which
+     *     runs to the start of the next tier or the end of the list
+     *   - the records, starting on an 8 byte boundary, one per seed in seed order: a u8 SolveStatus,
+     *     the u8 tier (NO_TIER unless solved), the u16 length of the solution found and the u32
+     *     difficulty, the positions the solver searched before finding it; both saturate
+     *   - the winnable list, the u32 seed of every solved deal, by tier and then by seed
+     *
+     * Tiers split the winnable deals into groups of about equal size by difficulty, easiest first.
+     */
+    namespace dealdatabase {
+        constexpr char MAGIC[8] = {'S', 'L', 'T', 'D', 'E', 'A', 'L', 'S'};
+        constexpr std::uint16_t VERSION = 1;
+        constexpr std::size_t HEADER_SIZE = 32;
+        constexpr std::size_t RECORD_SIZE = 8;
+        constexpr std::size_t MAX_TIERS = 16;
+        constexpr std::uint8_t NO_TIER = 0xFF;
+    }
+
+    /**
+     * @brief A deal database mapped into memory: what solving each seed of a range found,
+     * looked up by seed and sampled by tier in constant time, without reading the whole file.
+     */
+    class DealDatabase {
+    public:
+        /// @brief What solving one seed found.
+        struct Deal {
+            SolveStatus status;
+            std::uint8_t tier; // dealdatabase::NO_TIER unless solved
+            std::uint16_t solutionLength;
+            std::uint32_t difficulty; // positions searched to solve it
+        };
+
+    private:
+        MappedFile file;
+        std::uint8_t drawCount = 1;
+        std::uint8_t tiers = 0;
+        std::uint32_t firstSeed = 0;
+        std::uint32_t seedCount = 0;
+        std::uint32_t winnableCount = 0;
+        std::uint32_t nodeLimit = 0;
+        const unsigned char *tierTable = nullptr;
+        const unsigned char *records = nullptr;
+        const unsigned char *winnable = nullptr;
+
+        std::uint32_t tierStart(std::size_t tier) const noexcept;
+        std::uint32_t winnableSeed(std::size_t i) const noexcept;
+
+    public:
+        /**
+         * @brief Maps the database at path and checks its header and tier table.
+         * @throws std::system_error If the file cannot be opened or mapped.
+         * @throws solitaire::InvalidDealDatabaseException If it is not a valid database of this version.
+         */
+        explicit DealDatabase(const std::string& path);
+
+        /**
+         * @brief Writes a database of consecutive seeds, splitting the solved ones into tiers.
+         * @param path Where to write it, replacing the file.
+         * @param drawCount The draw count the deals were solved with.
+         * @param firstSeed The seed of deals[0]; the others follow in order.
+         * @param deals What solving each seed found; their tiers are ignored and assigned here.
+         * @param tierCount How many tiers to split the winnable deals into, from 1 to MAX_TIERS.
+         * @param nodeLimit The node limit the solver had, recorded for reference.
+         * @throws std::invalid_argument If tierCount is out of range or there are too many deals.
+         * @throws std::runtime_error If the file cannot be written.
+         */
+        static void write(
+            const std::string& path,
+            std::uint8_t drawCount,
+            std::uint32_t firstSeed,
+            const std::vector<Deal>& deals,
+            std::size_t tierCount,
+            std::uint32_t nodeLimit
+        );
+
+        /// @brief Checks if the database has a record for seed.
+        bool contains(std::uint32_t seed) const noexcept;
+
+        /**
+         * @brief Gets the record of seed.
+         * @throws std::out_of_range If the database has no record for it.
+         */
+        Deal lookup(std::uint32_t seed) const;
+
+        /**
+         * @brief Picks a uniformly random winnable seed.
+         * @throws std::out_of_range If no deal in the database is winnable.
+         */
+        template <typename URNG>
+        std::uint32_t sampleWinnable(URNG& rand) const {
+            if (this->winnableCount == 0) {
+                throw std::out_of_range("The deal database has no winnable deals");
+            }
+            return this->winnableSeed(std::uniform_int_distribution<std::uint32_t>(0, this->winnableCount - 1)(rand));
+        }
+
+        /**
+         * @brief Picks a uniformly random seed of a tier.
+         * @throws std::out_of_range If there is no such tier or it is empty.
+         */
+        template <typename URNG>
+        std::uint32_t sampleTier(std::size_t tier, URNG& rand) const {
+            std::size_t size = this->getTierSize(tier);
+            if (size == 0) {
+                throw std::out_of_range("The deal database has no deals in tier " + std::to_string(tier));
+            }
+            std::uint32_t i = std::uniform_int_distribution<std::uint32_t>(0, static_cast<std::uint32_t>(size - 1))(rand);
+            return this->winnableSeed(this->tierStart(tier) + i);
+        }
+
+        std::uint8_t getDrawCount() const noexcept;
+        std::uint32_t getFirstSeed() const noexcept;
+        std::uint32_t getSeedCount() const noexcept;
+        std::uint32_t getWinnableCount() const noexcept;
+        std::uint32_t getNodeLimit() const noexcept;
+        std::size_t getTierCount() const noexcept;
+
+        /**
+         * @brief Gets how many winnable deals a tier has.
+         * @throws std::out_of_range If there is no such tier.
+         */
+        std::size_t getTierSize(std::size_t tier) const;
+    };
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+namespace solitaire {
+    /**
+     * @brief A fixed-size array with one element for each value of an enum, indexed by the enum itself.
+     * Indexing turns the enum straight into an offset: no hashing and no allocation.
+     * @tparam E An enum whose values run contiguously from E::FIRST, with E::COUNT of them (e.g. Suit or Face).
+     * @tparam T The type of the elements.
+     */
+    template <typename E, typename T>
+    class EnumArray {
+    public:
+        static constexpr std::size_t SIZE = static_cast<std::size_t>(E::COUNT);
+
+    private:
+        std::array<T, SIZE> values {};
+
+        static constexpr std::size_t offset(E key) noexcept {
+            return static_cast<std::size_t>(key) - static_cast<std::size_t>(E::FIRST);
+        }
+
+    public:
+        /// @brief Gets the element for key, which must be one of the enum's values from E::FIRST on.
+        constexpr T& operator[](E key) noexcept {
+            return this->values[offset(key)];
+        }
+
+        constexpr const T& operator[](E key) const noexcept {
+            return this->values[offset(key)];
+        }
+
+        /**
+         * @brief Gets the element for key, checking it first.
+         * @throws std::out_of_range If key is not one of the enum's values, e.g. E::END.
+         */
+        T& at(E key) {
+            return this->values.at(offset(key));
+        }
+
+        const T& at(E key) const {
+            return this->values.at(offset(key));
+        }
+
+        static constexpr std::size_t size() noexcept {
+            return SIZE;
+        }
+
+        constexpr auto begin() noexcept {
+            return this->values.begin();
+        }
+
+        constexpr auto end() noexcept {
+            return this->values.end();
+        }
+
+        constexpr auto begin() const noexcept {
+            return this->values.begin();
+        }
+
+        constexpr auto end() const noexcept {
+            return this->values.end();
+        }
+    };
+}
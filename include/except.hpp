@@ -1,6 +1,7 @@
 #pragma once
 
 #include <exception>
+#include <stdexcept>
 
 namespace solitaire {
     /// @brief Thrown when an operation requires more cards than there are available.
@@ -17,4 +18,28 @@ namespace solitaire {
 
     /// @brief Thrown when the faces on the bottom pile's top card and on the top pile's bottom card are not sequential (according to the tableau/foundation rules).
     class NonSequentialFacesException : public InvalidCardPlacementException {};
-}
\ No newline at end of file
+
+    /// @brief Thrown when an asset pack file is malformed, truncated or of another version.
+    class InvalidAssetPackException : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /// @brief Thrown when a deal database file is malformed, truncated or of another version.
+    class InvalidDealDatabaseException : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /// @brief Thrown when a saved game is corrupt or of another version.
+    class InvalidSaveException : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /// @brief Thrown when an input recording file is malformed, truncated or of another version.
+    class InvalidRecordingException : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+}
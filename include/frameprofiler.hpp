@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "enumarray.hpp"
+
+namespace solitaire {
+    /// @brief The parts a frame is split into when profiling it, in the order they run.
+    enum class FramePhase {
+        INPUT,
+        FIRST = INPUT,
+        UPDATE,
+        RENDER,
+        PRESENT, // EndDrawing: the buffer swap and waiting out the target frame rate
+        END,
+        COUNT = END
+    };
+
+    FramePhase& operator++(FramePhase& phase);
+    FramePhase operator++(FramePhase& phase, int);
+
+    /// @brief Gets the name of phase as shown in profiles, e.g. "render".
+    const char *framePhaseToString(FramePhase phase);
+
+    /**
+     * @brief Times the phases of each frame and counts the draw calls and texture binds it issues.
+     *
+     * The last HISTORY frames are kept whole for an on-screen graph and percentiles, and every
+     * frame of the session is added to fixed-size histograms, so a report covering the whole
+     * session can be written at exit without the memory growing with its length.
+     */
+    class FrameProfiler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// @brief How many of the latest frames are kept whole.
+        static constexpr std::size_t HISTORY = 240;
+        /// @brief Width of each histogram bucket, in milliseconds.
+        static constexpr double BUCKET_MS = 0.5;
+        /// @brief Histogram buckets; the last one also holds every longer frame.
+        static constexpr std::size_t BUCKETS = 100;
+
+        /// @brief What was measured of a single frame.
+        struct Frame {
+            EnumArray<FramePhase, float> milliseconds;
+            float totalMilliseconds;
+            std::uint32_t drawCalls;
+            std::uint32_t textureBinds;
+            bool handledInput; // see markInputHandled()
+        };
+
+        struct Percentiles {
+            double p50;
+            double p95;
+            double p99;
+            double max;
+        };
+
+    private:
+        struct Histogram {
+            std::array<std::uint64_t, BUCKETS> counts {};
+            double sum = 0;
+            double max = 0;
+
+            void add(double milliseconds);
+            Percentiles percentiles() const;
+        };
+
+        std::array<Frame, HISTORY> history {};
+        std::size_t nextFrame = 0; // where the next frame goes in history
+        std::size_t recorded = 0; // frames in history, up to HISTORY
+
+        EnumArray<FramePhase, Histogram> phaseHistograms;
+        Histogram frameHistogram;
+        Histogram inputHistogram; // whole frames that handled input: handled-to-present
+        std::uint64_t sessionFrames = 0;
+        std::uint64_t sessionInputFrames = 0;
+        std::uint64_t sessionDrawCalls = 0;
+        std::uint64_t sessionTextureBinds = 0;
+        std::uint32_t maxDrawCalls = 0;
+        std::uint32_t maxTextureBinds = 0;
+
+        Frame current {};
+        FramePhase currentPhase = FramePhase::INPUT;
+        Clock::time_point phaseStart;
+        unsigned boundTexture = 0; // 0 for none yet this frame
+
+        void endPhase(Clock::time_point now);
+
+        template <typename Select>
+        Percentiles recentPercentiles(Select select) const;
+
+    public:
+        /// @brief Starts timing a new frame, beginning with its INPUT phase.
+        void beginFrame();
+
+        /// @brief Ends the phase running and starts timing phase, which must come after it.
+        void beginPhase(FramePhase phase);
+
+        /**
+         * @brief Ends the last phase of the frame.
+         * @param keep Whether to record the frame; false for frames that are not worth
+         * measuring, e.g. ones that slept until the next input event.
+         */
+        void endFrame(bool keep = true);
+
+        /**
+         * @brief Counts a draw call, and a texture bind if it uses another texture than the one before.
+         * @param textureId The id of the texture the call draws from.
+         */
+        void countDraw(unsigned textureId);
+
+        /// @brief Gets how many of the latest frames are kept, up to HISTORY.
+        std::size_t recentFrames() const;
+
+        /// @brief Gets a kept frame, from 0 for the oldest to recentFrames() - 1 for the latest.
+        const Frame& recentFrame(std::size_t i) const;
+
+        /// @brief Gets the percentiles of a phase's time over the kept frames, in milliseconds.
+        Percentiles recentPercentiles(FramePhase phase) const;
+
+        /// @brief Gets the percentiles of whole frame times over the kept frames, in milliseconds.
+        Percentiles recentFramePercentiles() const;
+
+        /**
+         * @brief Marks the frame as one that handled input, which the frame begins with.
+         * The frame's total time is then its handled-to-present latency: from the input being
+         * handled to EndDrawing returning. That includes the buffer swap and the wait for the
+         * target frame rate after it, but not what the compositor and display add.
+         */
+        void markInputHandled();
+
+        /// @brief Gets the percentiles of handled-to-present latency over the kept frames that handled input,
+        /// in milliseconds; all 0 if none did.
+        Percentiles recentInputPercentiles() const;
+
+        /**
+         * @brief Writes the timings and counters of every frame recorded this session, in text.
+         * Session percentiles are rounded up to the histogram buckets they fall in.
+         */
+        void writeReport(std::ostream& out) const;
+    };
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "move.hpp"
+#include "slt.hpp"
+#include "solver.hpp"
+
+namespace solitaire {
+    /// @brief What a HintEngine has to say about the latest position it was given.
+    enum class HintStatus : std::uint8_t {
+        PENDING, // still searching the latest position
+        WINNING, // the move starts a winning line
+        PROMISING, // no winning line was found in time; the move is the one the solver would try first
+        NO_WIN, // no winning line exists, or no move is left
+        WON, // the position is already won; there is nothing left to hint
+    };
+
+    /**
+     * @brief Searches for hints on a worker thread, so the thread drawing frames never waits for one.
+     *
+     * Each position handed to submit() is copied and given a new generation number, and any
+     * search still running is cancelled. The worker solves the latest copy within a time budget
+     * and publishes its answer, tagged with the generation it belongs to, through a single atomic
+     * word. latest() reads that word without locking and ignores answers of older generations,
+     * so a result that comes in after the board changed is never shown.
+     */
+    class HintEngine {
+        Solver solver;
+
+        std::mutex mutex; // guards the fields below and clearing the solver's cancel flag
+        std::condition_variable wake;
+        std::optional<Game> pending;
+        std::uint32_t submitted = 0; // generation of pending
+        bool stopping = false;
+
+        // generation (24 bits) | status (8 bits) | move (32 bits)
+        std::atomic<std::uint64_t> published {0};
+        std::atomic<std::uint32_t> latestGeneration {0};
+
+        std::thread worker;
+
+        void work();
+
+        static std::uint64_t pack(std::uint32_t generation, HintStatus status, Move move) noexcept;
+
+    public:
+        /**
+         * @brief Starts the worker thread, which sleeps until a position is submitted.
+         * @param budget How long each position may be searched for.
+         */
+        explicit HintEngine(std::chrono::milliseconds budget);
+
+        /// @brief Cancels any running search and joins the worker.
+        ~HintEngine();
+
+        HintEngine(const HintEngine&) = delete;
+        HintEngine& operator=(const HintEngine&) = delete;
+
+        /**
+         * @brief Hands over a new position to search, dropping any hint for an older one.
+         * Only copies the game, so it is cheap enough to call after every move.
+         * @param game The position; it must not be holding cards.
+         */
+        void submit(const Game& game);
+
+        /**
+         * @brief Gets the hint for the latest submitted position, without waiting.
+         * @param move Receives the hinted move if the status is WINNING or PROMISING.
+         * @return PENDING until the worker is done with the latest position.
+         */
+        HintStatus latest(Move& move) const noexcept;
+    };
+}
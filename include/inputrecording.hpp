@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace solitaire {
+    /**
+     * @brief The layout of input recording files.
+     *
+     * All integers are little-endian:
+     *   - a 20 byte header: the magic "SLTINPUT", a u16 version, a u8 draw count, a reserved byte,
+     *     the u32 seed the game was dealt from, then the u16 width and u16 height of a card in
+     *     pixels, which the hit tests of the recorded positions depend on
+     *   - the events until the end of the file, each a u8 InputEventType, the microseconds since
+     *     the previous event as an unsigned LEB128 varint, then for mouse events the f32 x and y
+     *     of the mouse
+     */
+    namespace inputrecording {
+        constexpr char MAGIC[8] = {'S', 'L', 'T', 'I', 'N', 'P', 'U', 'T'};
+        constexpr std::uint16_t VERSION = 1;
+        constexpr std::size_t HEADER_SIZE = 20;
+    }
+
+    /// @brief What a recorded input did, named after the GraphicalGame function it was handed to.
+    enum class InputEventType : std::uint8_t {
+        PRESS,
+        DRAG,
+        RELEASE,
+        UNDO,
+        REDO,
+        END
+    };
+
+    struct InputEvent {
+        InputEventType type;
+        double time; // seconds since the first event
+        float x; // mouse position, for PRESS, DRAG and RELEASE
+        float y;
+    };
+
+    /**
+     * @brief A game's seed and every input handed to it, enough to play the game again exactly.
+     * Times are kept in whole microseconds since the first event, and recording hands back the
+     * time as it will be replayed, so a live game and its replay see the same times.
+     */
+    class InputRecording {
+        std::uint32_t seed;
+        std::uint8_t drawCount;
+        std::uint16_t cardWidth;
+        std::uint16_t cardHeight;
+
+        std::vector<InputEvent> events;
+        double startTime = 0; // on the caller's clock, when the first event came
+        std::uint64_t lastMicroseconds = 0;
+
+    public:
+        InputRecording(std::uint32_t seed, std::uint8_t drawCount, std::uint16_t cardWidth, std::uint16_t cardHeight);
+
+        /**
+         * @brief Appends an event.
+         * @param time When it happened, in seconds on any clock that does not go back.
+         * @return The time as it is recorded, in seconds since the first event.
+         */
+        double add(InputEventType type, double time, float x = 0, float y = 0);
+
+        /**
+         * @brief Writes the recording to path, replacing the file.
+         * @throws std::runtime_error If the file cannot be written.
+         */
+        void save(const std::string& path) const;
+
+        /**
+         * @brief Reads a recording written by save.
+         * @throws std::system_error If the file cannot be opened or mapped.
+         * @throws solitaire::InvalidRecordingException If it is not a valid recording of this version.
+         */
+        static InputRecording load(const std::string& path);
+
+        std::uint32_t getSeed() const noexcept;
+        std::uint8_t getDrawCount() const noexcept;
+        std::uint16_t getCardWidth() const noexcept;
+        std::uint16_t getCardHeight() const noexcept;
+        const std::vector<InputEvent>& getEvents() const noexcept;
+    };
+}
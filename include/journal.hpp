@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "move.hpp"
+
+namespace solitaire {
+    class Game;
+
+    /**
+     * @brief The history of moves played on a Game, supporting undo and redo.
+     * Each step reverts or replays a single packed MoveRecord, in constant time,
+     * without ever copying the board.
+     */
+    class MoveJournal {
+        std::vector<MoveRecord> records;
+        std::size_t played = 0; // records [0, played) are on the board; the rest can be redone
+
+    public:
+        /**
+         * @brief Appends a freshly played move, discarding any moves that could have been redone.
+         * Empty records are ignored.
+         * @param record The record of the move.
+         */
+        void record(const MoveRecord& record);
+
+        /// @brief Checks if there is a move to undo.
+        bool canUndo() const noexcept;
+
+        /// @brief Checks if there is an undone move to replay.
+        bool canRedo() const noexcept;
+
+        /**
+         * @brief Takes back the last played move.
+         * @param game The game the moves were played on; it must not be holding cards.
+         * @return false if there was nothing to undo.
+         */
+        bool undo(Game& game) noexcept;
+
+        /**
+         * @brief Replays the last undone move.
+         * @param game The game the moves were played on; it must not be holding cards.
+         * @return false if there was nothing to redo.
+         */
+        bool redo(Game& game) noexcept;
+
+        /// @brief Forgets every move.
+        void clear() noexcept;
+
+        /// @brief Gets how many moves are currently on the board.
+        std::size_t size() const noexcept;
+    };
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace solitaire {
+    /**
+     * @brief A whole file mapped read-only into memory, unmapped on destruction.
+     * Uses mmap on POSIX systems and CreateFileMapping on Windows, so pages are only
+     * read from disk once they are touched and are shared with the OS file cache.
+     */
+    class MappedFile {
+        const unsigned char *bytes = nullptr;
+        std::size_t length = 0;
+
+        void unmap() noexcept;
+
+    public:
+        /// @brief Creates an empty mapping, holding no file.
+        MappedFile() = default;
+
+        /**
+         * @brief Maps the whole file at path.
+         * @throws std::system_error If the file cannot be opened or mapped.
+         */
+        explicit MappedFile(const std::string& path);
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        ~MappedFile();
+
+        /// @brief Gets the first byte of the file; nullptr if it is empty.
+        const unsigned char *data() const noexcept;
+
+        /// @brief Gets the size of the file in bytes.
+        std::size_t size() const noexcept;
+    };
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace solitaire {
+    /// @brief The kinds of moves a player can make on a Game.
+    enum class MoveType : std::uint8_t {
+        TURN_STOCK, // stock -> waste
+        RECYCLE_WASTE, // waste -> stock, once the stock is empty
+        WASTE_TO_TABLEAU,
+        WASTE_TO_FOUNDATION,
+        TABLEAU_TO_TABLEAU,
+        TABLEAU_TO_FOUNDATION,
+        FOUNDATION_TO_TABLEAU,
+        TURN_CLOSED_TABLEAU, // flips the top closed card of an empty open tableau
+    };
+
+    /**
+     * @brief A single move, packed into 4 bytes.
+     * from and to hold a tableau index or a Suit (as an integer) depending on the
+     * piles involved; unused fields are 0.
+     */
+    struct Move {
+        MoveType type;
+        std::uint8_t from;
+        std::uint8_t to;
+        std::uint8_t count; // how many cards the move carries
+
+        bool operator==(const Move& other) const noexcept {
+            return this->type == other.type
+                && this->from == other.from
+                && this->to == other.to
+                && this->count == other.count;
+        }
+
+        bool operator!=(const Move& other) const noexcept {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * @brief A Move as it was played, with everything needed to take it back.
+     * A record whose move carries no cards is empty: nothing was played.
+     */
+    struct MoveRecord {
+        Move move;
+        bool flippedClosedCard; // a closed tableau card was turned up after the move
+
+        bool empty() const noexcept {
+            return this->move.count == 0;
+        }
+    };
+
+    /**
+     * @brief Writes a short human readable form of a Move, e.g. "t2>t5x3" or "w>f".
+     */
+    std::ostream& operator<<(std::ostream& os, const Move& move) noexcept;
+
+    /**
+     * @brief A fixed-capacity list of moves meant to live on the stack.
+     * CAPACITY is an upper bound on the number of legal moves in any Klondike position.
+     */
+    class MoveBuffer {
+    public:
+        static constexpr std::size_t CAPACITY = 128;
+
+    private:
+        std::array<Move, CAPACITY> moves;
+        std::size_t count = 0;
+
+    public:
+        /**
+         * @brief Appends a move to the buffer.
+         * The buffer must hold fewer than CAPACITY moves.
+         * @param m The move to append.
+         */
+        void push(Move m) noexcept {
+            this->moves[this->count++] = m;
+        }
+
+        /// @brief Removes every move from the buffer.
+        void clear() noexcept {
+            this->count = 0;
+        }
+
+        /// @brief Keeps only the first newSize moves; newSize must not exceed size().
+        void truncate(std::size_t newSize) noexcept {
+            this->count = newSize;
+        }
+
+        bool empty() const noexcept {
+            return this->count == 0;
+        }
+
+        std::size_t size() const noexcept {
+            return this->count;
+        }
+
+        Move& operator[](std::size_t index) noexcept {
+            return this->moves[index];
+        }
+
+        const Move& operator[](std::size_t index) const noexcept {
+            return this->moves[index];
+        }
+
+        auto begin() noexcept {
+            return this->moves.begin();
+        }
+
+        auto end() noexcept {
+            return this->moves.begin() + this->count;
+        }
+
+        auto begin() const noexcept {
+            return this->moves.cbegin();
+        }
+
+        auto end() const noexcept {
+            return this->moves.cbegin() + this->count;
+        }
+    };
+}
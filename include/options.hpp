@@ -8,6 +8,9 @@ namespace config {
         THREE
     };
 
+    /// @brief How many cards new games pull off of the stock at once.
+    inline wasteDifficulty stockDraw = wasteDifficulty::ONE;
+
     /// @brief Automatically place card from waste when clicked.
     inline bool autoplayFromWaste = true;
     /// @brief Automatically find a place for clicked tableau.
@@ -17,7 +20,31 @@ namespace config {
     /// @brief Automatically flip top card of hidden tableau stack when it's exposed.
     inline bool autoplayClosedTableauTop = true;
 
-    /// @brief How many frames defines a click vs. a drag.
-    inline int framesToIgnoreClick = 10;
+    /// @brief Deal only games known to be winnable, picked from the deal database.
+    inline bool winnableDealsOnly = false;
+    /// @brief Deal only winnable games of this difficulty tier of the deal database, 0 being
+    /// the easiest; -1 for any.
+    inline int dealTier = -1;
+
+    /// @brief How long the hint engine may search each position for.
+    inline int hintMilliseconds = 500;
+
+    /// @brief Sleep until the next input event instead of redrawing at full frame rate
+    /// while no cards are being dragged.
+    inline bool waitForEventsWhenIdle = true;
+
+    /// @brief How many seconds a press may last and still count as a click rather than a drag.
+    inline double secondsToIgnoreClick = 1.0 / 6;
+
+    /// @brief Where to write the frame timings and draw counts of the session on exit; empty to not write them.
+    inline const char *frameProfilePath = "frameprofile.txt";
+
+    /// @brief Where to write the seed and every input of the session on exit, to replay it
+    /// with `--replay`; empty to not write them.
+    inline const char *inputRecordingPath = "lastgame.sltinput";
+
+    /// @brief Where the game in progress is saved on exit and resumed from on the next start;
+    /// empty to always deal a new game.
+    inline const char *savePath = "savegame.sltsave";
 
 }
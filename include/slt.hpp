@@ -1,33 +1,82 @@
 #pragma once
 
 #include <array>
-#include <unordered_map>
 #include <map>
 #include <algorithm>
 #include <random>
 
 #include "card.hpp"
+#include "enumarray.hpp"
 #include "except.hpp"
-#include "sltconfig.hpp"
+#include "move.hpp"
+#include "options.hpp"
+#include "sltrules.hpp"
 
 namespace solitaire {
+    /// @brief The outcome of checking or attempting a card placement.
+    /// Each failure mirrors one of the exceptions thrown by the throwing API.
+    enum class PlacementResult {
+        OK,
+        NO_SUCH_PILE, // std::out_of_range
+        NO_CARDS, // solitaire::NotEnoughCardsException
+        TOO_MANY_CARDS, // solitaire::TooManyCardsException
+        MISMATCHED_SUITS, // solitaire::MismatchedSuitsException
+        NON_SEQUENTIAL_FACES, // solitaire::NonSequentialFacesException
+        NOT_A_KING, // solitaire::InvalidCardPlacementException, on an empty tableau
+        NOT_AN_ACE, // solitaire::InvalidCardPlacementException, on an empty foundation
+    };
+
+    /// @brief Checks if cards of the two suits have opposite colors, so they can alternate on a tableau.
+    bool suitsCanAlternate(Suit s1, Suit s2) noexcept;
+
+    /// @brief Gets a human readable description of a PlacementResult.
+    /// @param r The result to describe.
+    /// @return A static, null-terminated string.
+    const char *placementResultToString(PlacementResult r) noexcept;
+
+    /// @brief Throws the exception matching a failed PlacementResult; does nothing for PlacementResult::OK.
+    /// @param r The result to check.
+    void throwIfFailed(PlacementResult r);
+
+    /// @brief Checks whether newCard may be placed on top of an open tableau.
+    /// @param pile The open tableau.
+    /// @param newCard The card that would touch the top of the tableau.
+    /// @return PlacementResult::OK if the placement follows the tableau rules; the reason it doesn't otherwise.
+    PlacementResult canPlaceOnTableau(const CardPile& pile, Card newCard) noexcept;
+
+    /// @brief Checks whether newCard may be placed on top of the foundation for foundationSuit.
+    /// @param foundationSuit The suit of the foundation.
+    /// @param pile The foundation pile.
+    /// @param newCard The card to place.
+    /// @return PlacementResult::OK if the placement follows the foundation rules; the reason it doesn't otherwise.
+    PlacementResult canPlaceOnFoundation(Suit foundationSuit, const CardPile& pile, Card newCard) noexcept;
+
     class Game {
     public:
-        /// @brief Destroys the game and all Cards allocated for it.
-        ~Game();
-
         /// @brief Creates and fully initializes a game.
         /// @tparam URNG The uniform PRNG type to shuffle the cards with.
         /// @param rand The uniform PRNG instance to use.
+        /// @param difficulty How many cards each turn of the stock pulls.
         /// @return The shuffled and dealt Game.
         template<typename URNG>
-        static Game *createAndDealGame(URNG& rand) {
+        static Game *createAndDealGame(URNG& rand, config::wasteDifficulty difficulty = config::stockDraw) {
             Game *g = new Game();
+            g->drawCount = difficulty == config::wasteDifficulty::THREE ? 3 : 1;
             g->shuffleStock(rand);
             g->dealGame();
             return g;
         }
 
+        /// @brief Creates the game a seed stands for, shuffled by a std::minstd_rand seeded with it.
+        /// This is how GraphicalGame deals its seeds, so tools get the very same deals.
+        /// @param seed The seed of the deal.
+        /// @param difficulty How many cards each turn of the stock pulls.
+        /// @return The shuffled and dealt Game.
+        static Game *createFromSeed(
+            std::minstd_rand::result_type seed,
+            config::wasteDifficulty difficulty = config::stockDraw
+        );
+
         /// @brief Deals the closed and open tableaus to start the game.
         /// @throws solitaire::NotEnoughCardsException If the deck has too few cards to deal a full game;
         /// should only happen when either NUM_TABLEAUS is increased, or the Suit or Face enums are changed.
@@ -37,13 +86,39 @@ namespace solitaire {
         /// @return false if the stock is empty; true otherwise.
         bool hasStock() const noexcept;
 
-        /// @brief Turns a card from the stock onto the waste.
+        /// @brief Turns getDrawCount() cards from the stock onto the waste, or what is left of the stock.
         /// @throws solitaire::NotEnoughCardsException If the stock is empty.
-        void turnStock();
+        /// @return The record of the move, for undoing it.
+        MoveRecord turnStock();
+
+        /// @brief Gets how many cards each turn of the stock pulls: 1, or 3 when drawing three.
+        std::size_t getDrawCount() const noexcept;
 
         /// @brief Turns the waste pile onto the stock.
         /// @throws std::logic_error if the stock is not empty.
-        void returnWasteToStock();
+        /// @return The record of the move, for undoing it; empty if the waste was empty too.
+        MoveRecord returnWasteToStock();
+
+        /// @brief Gets the stock, whose top card is the next one to be turned.
+        /// @return The stock pile.
+        const CardPile& getStock() const noexcept;
+
+        /// @brief Gets the waste, whose top card is the only one that can be played.
+        /// @return The waste pile.
+        const CardPile& getWaste() const noexcept;
+
+        /// @brief Gets the stock cards that turning alone can bring to the top of the waste
+        /// before the waste is next recycled.
+        /// When drawing three these are every third card from the top of the stock and its bottom card.
+        /// Kept up to date incrementally by every move.
+        /// @return A set of cards, bit Card::index() standing for each.
+        std::uint64_t getReachableThisPass() const noexcept;
+
+        /// @brief Gets the stock and waste cards that turning alone can bring to the top of the waste
+        /// on every pass after this one, as long as no card is played from the waste.
+        /// Kept up to date incrementally by every move.
+        /// @return A set of cards, bit Card::index() standing for each.
+        std::uint64_t getReachableLaterPasses() const noexcept;
 
         /// @brief Checks the card on top of the waste.
         /// @return nullptr if the waste is empty; a pointer to the top card otherwise.
@@ -57,14 +132,14 @@ namespace solitaire {
 
         /// @brief Gets the currently held card pile.
         /// @return The pile of currently held cards.
-        const CardPile& getHeldCards();
+        const CardPile& getHeldCards() const noexcept;
 
         /// @brief Takes the card on top of the waste into the held cards.
         /// @throws solitaire::NotEnoughCardsException If the waste is empty.
         /// @throws std::logic_error If there are already cards being held.
         void takeWaste();
 
-        bool hasWaste();
+        bool hasWaste() const noexcept;
 
         /// @brief Takes the card on top of the chosen foundation into the held cards.
         /// @param s solitaire::Suit Which foundation to take from.
@@ -98,7 +173,8 @@ namespace solitaire {
         /// @throws std::out_of_range if there is no tableau at index index.
         /// @throws std::logic_error if either the open tableau at index is not empty,
         /// or if the closed tableau at index is empty.
-        void turnClosedTableauTop(std::size_t index);
+        /// @return The record of the move, for undoing it.
+        MoveRecord turnClosedTableauTop(std::size_t index);
 
         /// @brief Attempts to stack the held CardPile on top of the open tableau at index index.
         /// @param index Which tableau to stack onto.
@@ -110,34 +186,137 @@ namespace solitaire {
         /// follow the top card of the given open tableau.
         /// @throws solitaire::InvalidCardPlacementException If the open tableau is empty and the base
         /// of the pile is not a king.
-        void stackTableau(std::size_t index);
+        /// @return The record of the move, for undoing it; empty if the cards went back where they came from.
+        MoveRecord stackTableau(std::size_t index);
+
+        /// @brief Checks whether the held CardPile could be stacked on the open tableau at index index.
+        /// @param index Which tableau to check.
+        /// @return PlacementResult::OK if stackTableau(index) would succeed; the reason it would throw otherwise.
+        PlacementResult canPlaceHeldOnTableau(std::size_t index) const noexcept;
+
+        /// @brief Non-throwing version of stackTableau; the game is left untouched on failure.
+        /// @param index Which tableau to stack onto.
+        /// @param record If not nullptr, receives the record of the move when one was played.
+        /// It is left untouched if the cards went back where they came from.
+        /// @return PlacementResult::OK if the cards were stacked; the reason they weren't otherwise.
+        PlacementResult tryStackTableau(std::size_t index, MoveRecord *record=nullptr) noexcept;
 
         /// @brief Attempts to stack the held CardPile on top of the foundation for the given Suit.
         /// @param suit The suit whose foundation will be stacked onto.
         /// @throws std::out_of_range If the given suit is invalid or the special value Suit::END.
         /// @throws solitaire::NotEnoughCardsException If the held cards pile is empty.
         /// @throws solitaire::TooManyCards If the held cards pile contains more than 1 card.
-        void stackFoundation(Suit suit);
+        /// @return The record of the move, for undoing it; empty if the card went back where it came from.
+        MoveRecord stackFoundation(Suit suit);
+
+        /// @brief Checks whether the held CardPile could be stacked on the foundation for the given Suit.
+        /// @param suit The suit whose foundation would be stacked onto.
+        /// @return PlacementResult::OK if stackFoundation(suit) would succeed; the reason it would throw otherwise.
+        PlacementResult canPlaceHeldOnFoundation(Suit suit) const noexcept;
+
+        /// @brief Non-throwing version of stackFoundation; the game is left untouched on failure.
+        /// @param suit The suit whose foundation will be stacked onto.
+        /// @param record If not nullptr, receives the record of the move when one was played.
+        /// It is left untouched if the card went back where it came from.
+        /// @return PlacementResult::OK if the card was stacked; the reason it wasn't otherwise.
+        PlacementResult tryStackFoundation(Suit suit, MoveRecord *record=nullptr) noexcept;
 
         /// @brief Checks if the foundation stack is empty.
         /// @param suit The suit whose foundation will be checked.
         /// @return If it has a card.
-        bool hasFoundation(Suit suit);
+        bool hasFoundation(Suit suit) const;
 
         /// @brief Get the total moves in the game.
         /// @return The number of moves.
-        int getMoveCount();
+        int getMoveCount() const noexcept;
+
+        /// @brief Checks if every card made it to the foundations.
+        /// @return true if the game is won.
+        bool isWon() const noexcept;
 
         /// @brief Attempts to put the held singular card onto the foundation pile.
-        void attemptHeldToFoundation();
+        /// @return The record of the move; empty if the card could not be placed.
+        MoveRecord attemptHeldToFoundation();
 
         /// @brief Attempts to put the held CardPile onto any valid tableau.
-        void attemptHeldToTableau();
+        /// @return The record of the move; empty if the cards could not be placed.
+        MoveRecord attemptHeldToTableau();
+
+        /// @brief Lists every legal move in the current position, without allocating.
+        /// Nothing is generated while cards are being held.
+        /// @param buffer Receives the moves; its previous contents are discarded.
+        void generateMoves(MoveBuffer& buffer) const noexcept;
+
+        /// @brief Lists the stock turns worth making, each a single TURN_STOCK move of several cards.
+        /// There is one for every card reachable this pass that could be played once it is on the waste,
+        /// plus one turning the rest of the stock so the waste can be recycled.
+        /// Searches can play these in place of the single turn from generateMoves, since turning the stock
+        /// commutes with every other move: a turned card only matters once it can be played.
+        /// @param buffer Receives the moves after any it already holds.
+        void generateStockJumps(MoveBuffer& buffer) const noexcept;
+
+        /// @brief Plays a move directly, without going through the held cards.
+        /// The move must be legal in the current position (as listed by generateMoves)
+        /// and no cards may be held; this is not checked.
+        /// @param move The move to play.
+        /// @return The record of the move, which revert() takes to undo it.
+        MoveRecord apply(const Move& move) noexcept;
+
+        /// @brief Takes back the most recent move, in constant time.
+        /// Records must be reverted in the reverse order they were played, with no cards held.
+        /// @param record The record returned when the move was played.
+        void revert(const MoveRecord& record) noexcept;
+
+        /// @brief Gets the 64 bit Zobrist hash of the position.
+        /// It is kept up to date incrementally by every move, and held cards count as still
+        /// lying on the pile they were taken from.
+        /// @return The hash of the current position.
+        std::uint64_t getHash() const noexcept;
+
+        /// @brief Computes the Zobrist hash of the position from scratch.
+        /// @return The same value as getHash() while no cards are held, at a much higher cost.
+        std::uint64_t computeHash() const noexcept;
+
+        /// @brief The version of the save format written by save().
+        static constexpr std::uint8_t SAVE_VERSION = 1;
+        /// @brief The size of a saved game in bytes.
+        static constexpr std::size_t SAVE_SIZE = 53;
+        /// @brief A saved game, see save().
+        using SaveData = std::array<std::uint8_t, SAVE_SIZE>;
+
+        /// @brief Writes the whole board, the draw count and the move count into out, without allocating.
+        /// The first byte is SAVE_VERSION; the rest is packed least significant bit first:
+        /// the draw count (1 bit, set for three), the move count (24 bits, saturating),
+        /// the size of each foundation (4 bits each, in Suit order), of the stock and the waste
+        /// (6 bits each), of each closed tableau (3 bits each) and of each open tableau (4 bits each),
+        /// then the Card::index() of every card not on a foundation (6 bits each): the stock, the waste,
+        /// the closed tableaus and then the open tableaus, each pile from its base up.
+        /// Foundations always hold the lowest faces of their suit, so their sizes are enough.
+        /// The undo history is not part of a save.
+        /// @param out Receives the save.
+        /// @throws std::logic_error If cards are being held.
+        void save(SaveData& out) const;
+
+        /// @brief Replaces this game with a saved one, without allocating.
+        /// The hash and the reachable card masks are recomputed rather than stored.
+        /// @param data A save written by save().
+        /// @return false if data is not a valid save of this version, leaving the game untouched.
+        bool load(const SaveData& data) noexcept;
+
+        /// @brief Creates a game from a save written by save().
+        /// @param data The save.
+        /// @return The restored Game.
+        /// @throws solitaire::InvalidSaveException If data is not a valid save of this version.
+        static Game *createFromSave(const SaveData& data);
 
     private:
         Game();
 
         int moves; // Moves taken in game.
+        std::uint64_t hash = 0; // Zobrist hash of the position.
+        std::uint8_t drawCount = 1; // Cards pulled by each turn of the stock.
+        std::uint64_t reachableThisPass = 0; // See getReachableThisPass.
+        std::uint64_t reachableLaterPasses = 0; // See getReachableLaterPasses.
         template<typename URNG>
         void shuffleStock(URNG& rand) {
             std::shuffle(this->stock.begin(), this->stock.end(), rand);
@@ -145,7 +324,7 @@ namespace solitaire {
 
         std::array<CardPile, NUM_TABLEAUS> openTableau;
         std::array<CardPile, NUM_TABLEAUS> closedTableau;
-        std::unordered_map<Suit, CardPile> foundation; // The piles that the cards at the end of a successful game.
+        EnumArray<Suit, CardPile> foundation; // The piles that the cards at the end of a successful game.
         CardPile stock; // The hidden cards to pull from.
         CardPile waste; // The pile of cards from the stock that hasn't been used.
         CardPile heldCards; // The cards being held with the cursor.
@@ -160,7 +339,8 @@ namespace solitaire {
             Suit foundationSuit;
         } heldSourcePileExtra;
 
-        std::vector<Card *> allCards;
+        CardPile& foundationPile(Suit s);
+        const CardPile& foundationPile(Suit s) const;
 
         void deal(CardPile& onto);
 
@@ -171,12 +351,36 @@ namespace solitaire {
         void dealOpenTableau();
 
         void throwIfAttemptingToHoldMoreCards();
-        void throwIfAttemptingToGrabEmptyPile(CardPile pile);
+        void throwIfAttemptingToGrabEmptyPile(const CardPile& pile);
+
+        /// @brief Flips the top closed card of tableau index if autoplay is on and it was just exposed.
+        /// @return Whether a card was flipped.
+        bool autoTurnClosedTableauTop(std::size_t index) noexcept;
+
+        /// @brief Gets how many moves turning amount cards off the stock counts as.
+        int stockTurnMoves(std::size_t amount) const noexcept;
+
+        /// @brief Checks if a card could go to its foundation or onto any tableau.
+        bool isPlayable(Card card) const noexcept;
+
+        /// @brief Recomputes reachableThisPass from the stock.
+        void computeReachableThisPass() noexcept;
+
+        /// @brief Recomputes reachableLaterPasses from the stock and waste.
+        void computeReachableLaterPasses() noexcept;
+
+        // piles indexed as in zobrist.hpp, so moves can update the hash as they go
+        CardPile& pileAt(std::size_t pile) noexcept;
+        const CardPile& pileAt(std::size_t pile) const noexcept;
+        std::size_t heldSourcePile() const noexcept;
+
+        /// @brief Moves amount cards between piles, keeping their order, and updates the hash.
+        void moveCards(std::size_t from, std::size_t to, std::size_t amount) noexcept;
+
+        /// @brief Moves amount cards between piles, reversing their order, and updates the hash.
+        void turnCards(std::size_t from, std::size_t to, std::size_t amount) noexcept;
 
-        /// @brief Allows you to check if a CardPile can stack on another.
-        /// @param bottom
-        /// @param top
-        /// @return If top is allowed on bottom.
-        bool canStack(const CardPile& bottom, const CardPile& top);
+        /// @brief Updates the hash for the held cards moving from their source pile onto pile to.
+        void hashHeldCardsLanding(std::size_t to) noexcept;
     };
 }
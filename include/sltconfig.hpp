@@ -1,10 +1,9 @@
 #pragma once
 
 #include "raylib.h"
+#include "sltrules.hpp"
 
 namespace solitaire {
-    static const int NUM_TABLEAUS = 7;
-
     const Vector2 TARGET_RESOLUTION = {1280, 720};
 
     const char CARD_TEXTURE_PATH_PREFIX[] = "assets/images/";
@@ -12,6 +11,12 @@ namespace solitaire {
     // path to the image file containing the back of cards
     const char CARD_BACK_TEXTURE_PATH_SUFFIX[] = "back/A.png";
 
+    // every card image decoded ahead of time by `make assets`; the images are decoded at startup without it
+    const char ASSET_PACK_PATH[] = "assets/cards.pack";
+
+    // every seed from 0 up solved ahead of time by `make deals`, to deal winnable games without solving them
+    const char DEAL_DATABASE_PATH[] = "assets/deals.db";
+
     const float CARD_SCALE = 1.0f;
 
     const Color BACKGROUND_COLOR = DARKGREEN;
@@ -27,6 +32,11 @@ namespace solitaire {
     // (full closed tableau + full open tableau)
     const int MIN_CARD_SHOWN_SIZE = STACKED_DISPLACEMENT;
 
+    // how many pixels the top waste cards are fanned out to the right when drawing three
+    const int WASTE_FAN_DISPLACEMENT = 25;
+    // the most waste cards shown fanned out at once
+    const int MAX_WASTE_FAN_SIZE = 3;
+
     // in pixels
     const float TINY_SPACING = 20;
     const float SMALL_SPACING = 50;
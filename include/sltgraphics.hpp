@@ -1,28 +1,40 @@
 #pragma once
 
+#include "enumarray.hpp"
+#include "frameprofiler.hpp"
+#include "hintengine.hpp"
+#include "inputrecording.hpp"
+#include "journal.hpp"
 #include "slt.hpp"
 #include "sltconfig.hpp"
 
 #include <raylib.h>
-#include <unordered_map>
 #include <memory>
 
 namespace solitaire {
     class GraphicalGame {
         GraphicalGame();
+        GraphicalGame(Vector2 cardSize);
 
-        void renderCardTexture(const Texture& texture, Vector2 position, Color=WHITE);
-        void renderCard(const Card& card, Vector2 position);
-        void renderCardFaceDown(Vector2 position);
+        void loadCardAtlas();
+        void loadCardAtlasFromPack(const char *path);
+        void loadCardAtlasFromImages();
+
+        void renderAtlasRegion(Rectangle source, Vector2 position, Color=WHITE);
+        void renderCard(const Card& card, Vector2 position, Color=WHITE);
+        void renderCardFaceDown(Vector2 position, Color=WHITE);
         void renderCardPileFaceUp(const CardPile& pile, Vector2 position);
         void renderCardPileFaceDown(std::size_t pileSize, Vector2& position);
 
+        void renderBoard();
         void renderUI();
         void renderStock();
         void renderWaste();
         void renderTableaus();
         void renderFoundations();
         void renderHeldCards();
+        void renderProfilerOverlay();
+        void renderHint();
 
         float cardWidth();
         float cardHeight();
@@ -30,6 +42,12 @@ namespace solitaire {
 
         float cardDragOverlapScore(Rectangle region);
 
+        std::size_t wasteFanSize();
+        Rectangle wasteTopRegion();
+        Rectangle tableauCardsRegion(std::size_t which, std::size_t count);
+        Rectangle hintSourceRegion(const Move& move);
+        Rectangle hintTargetRegion(const Move& move);
+
         void clickStock();
         void clickWaste(Vector2 mousePosition);
         void clickFoundation(Suit which, Vector2 mousePosition);
@@ -38,30 +56,49 @@ namespace solitaire {
         void cancelDrag();
 
         Rectangle stockRegion;
-        Rectangle wasteRegion;
+        Rectangle wasteRegion; // room for the widest fan of waste cards
         Rectangle tableauMacroRegion;
         std::array<Rectangle, NUM_TABLEAUS> tableauRegions;
         Rectangle foundationMacroRegion;
-        std::unordered_map<Suit, Rectangle> foundationRegions;
+        EnumArray<Suit, Rectangle> foundationRegions;
 
-        Game *game;
+        Game *game = nullptr;
+        MoveJournal journal;
         Vector2 actualResolution;
         float cardScale = 1.0f;
 
-        Vector2 dragPosition;
+        Vector2 dragPosition {0, 0};
         Vector2 dragOffset;
 
-        std::map<std::pair<Suit, Face>, Texture> cardTextures;
-        Texture cardBackTexture;
+        // every card face and the card back, packed into one texture so the board draws without rebinding
+        Texture cardAtlas;
+        std::array<Rectangle, Card::DECK_SIZE> cardAtlasRegions; // indexed by Card::index()
+        Rectangle cardBackAtlasRegion;
+
+        // everything but the held cards, redrawn only when boardDirty is set after the game changed
+        RenderTexture2D boardLayer;
+        bool boardDirty = true;
+
+        double clickStart = 0; // when the mouse was last pressed, in seconds
 
-        int frame = 0;
-        int clickStart;
+        // timed by the main loop; the draw calls are counted where they are made
+        FrameProfiler profiler;
+        bool showProfiler = false;
+
+        // every input handed to the game, to play it again; none when replaying or resuming a save
+        std::unique_ptr<InputRecording> recording;
+        bool headless = false; // no window, no textures and nothing to render
+
+        // started by the first hint asked for, then given every position the board reaches
+        std::unique_ptr<HintEngine> hints;
+        std::uint64_t hintedHash = 0; // the position hints were last asked about
+        bool showHint = false;
 
     public:
         GraphicalGame(std::minstd_rand::result_type seed);
 
         /**
-         * @brief Destroys all Cards and card Textures that have been allocated when creating this game.
+         * @brief Destroys the Game and all card Textures that have been allocated when creating this game.
          */
         ~GraphicalGame();
 
@@ -84,25 +121,65 @@ namespace solitaire {
             return std::unique_ptr<GraphicalGame>(ggame);
         }
 
-        /// @brief Updates the game.
+        /**
+         * @brief Creates a game to replay a recording into, without a window or textures.
+         * It lays the board out for the recorded card size and deals the recorded seed;
+         * it must not be rendered.
+         */
+        static std::unique_ptr<GraphicalGame> createForReplay(const InputRecording& recording);
+
+        /**
+         * @brief Hands every recorded event to the game, in order and as fast as possible.
+         * @param recording A recording made of a game dealt like this one.
+         */
+        void replay(const InputRecording& recording);
+
+        /**
+         * @brief Creates a game resuming the one saved at path by save().
+         * @return nullptr if there is no save at path.
+         * @throws solitaire::InvalidSaveException If the save is corrupt or of another version.
+         */
+        static std::unique_ptr<GraphicalGame> resume(const char *path);
+
+        /**
+         * @brief Saves the game to path to be resumed later, putting any held cards back first.
+         * A won game is not worth resuming, so its save is removed instead.
+         * @throws std::runtime_error If the file cannot be written.
+         */
+        void save(const char *path);
+
+        /// @brief Gets the inputs handed to the game so far; nullptr if it is not recording them.
+        const InputRecording *getRecording() const;
+
+        /// @brief Gets the game being played.
+        const Game& getGame() const;
+
+        /// @brief Updates the game: hands the hint engine the position if a move changed it.
         void update();
 
-        /// @brief Renders the game.
+        /// @brief Renders the game: the cached board, redrawn first if the game changed, then the held cards.
         void render();
 
         /**
          * @brief Signals a new click and possibly the start of a drag.
          * @param mousePosition Position of the click on the window.
+         * @param time When the press was sampled, in seconds (e.g. from GetTime()).
          */
-        void handleMousePress(Vector2 mousePosition);
+        void handleMousePress(Vector2 mousePosition, double time);
 
-        void handleMouseRelease(Vector2 mousePosition);
+        /**
+         * @brief Ends a click or a drag, told apart by how long ago the press was.
+         * @param mousePosition Position of the mouse when released.
+         * @param time When the release was sampled, on the same clock as handleMousePress.
+         */
+        void handleMouseRelease(Vector2 mousePosition, double time);
 
         /**
          * @brief Updates mouse position while dragging
          * @param mousePosition New mouse position while dragging.
+         * @param time When the position was sampled, on the same clock as handleMousePress.
          */
-        void handleDrag(Vector2 mousePosition);
+        void handleDrag(Vector2 mousePosition, double time);
 
         /// @brief Handles quick click, then release actions.
         /// @param mousePosition Position of the mouse when released.
@@ -114,6 +191,33 @@ namespace solitaire {
          */
         void releaseDrag(Vector2 mousePosition);
 
+        /// @brief Checks if cards are being dragged, which needs a new frame as often as possible.
+        bool isDragging() const;
+
+        /// @brief Takes back the last move, unless cards are being held.
+        /// @param time When it was asked for, on the same clock as handleMousePress.
+        void undo(double time);
+
+        /// @brief Replays the last undone move, unless cards are being held.
+        /// @param time When it was asked for, on the same clock as handleMousePress.
+        void redo(double time);
+
+        /// @brief Shows a hint for the current position, searched for on a worker thread.
+        /// It stays shown until the board changes.
+        void requestHint();
+
+        /// @brief Checks if a hint is shown but still being searched for, which needs new frames until it is found.
+        bool isWaitingForHint() const;
+
+        /// @brief Gets the profiler the main loop times frames with and rendering counts draws in.
+        FrameProfiler& getProfiler();
+
+        /// @brief Shows or hides the frame timing overlay.
+        void toggleProfilerOverlay();
+
+        /// @brief Checks if the frame timing overlay is shown, whose graph needs a new frame as often as possible.
+        bool isProfilerOverlayShown() const;
+
         /**
          * @brief Gets the width of the window.
          * @return std::size_t The width of the window.
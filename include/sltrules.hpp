@@ -0,0 +1,8 @@
+#pragma once
+
+// Constants of the rules themselves. The engine builds on these alone,
+// so nothing here may depend on raylib or any other graphics header.
+
+namespace solitaire {
+    static const int NUM_TABLEAUS = 7;
+}
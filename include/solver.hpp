@@ -0,0 +1,278 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "move.hpp"
+
+namespace solitaire {
+    class Game;
+
+    /// @brief Limits on how much work a solver may do before giving up.
+    struct SolverLimits {
+        /// @brief Positions to expand at most; 0 for no limit.
+        std::uint64_t maxNodes = 2'000'000;
+        /// @brief Wall clock time to search at most; 0 for no limit.
+        std::chrono::milliseconds maxTime = std::chrono::seconds(10);
+        /**
+         * @brief The transposition table has 2^tableBits slots.
+         * A Solver slot takes 8 bytes, 32 MiB at the default. A ParallelSolver slot takes 24,
+         * plus 3 for the list of used slots, 108 MiB at the default.
+         */
+        unsigned tableBits = 22;
+    };
+
+    enum class SolveStatus {
+        SOLVED, // a winning line was found
+        UNSOLVABLE, // the whole game tree was searched without finding one
+        UNKNOWN, // the search ran out of budget first
+    };
+
+    /// @brief Gets a human readable name for a SolveStatus.
+    const char *solveStatusToString(SolveStatus status) noexcept;
+
+    struct SolveResult {
+        SolveStatus status = SolveStatus::UNKNOWN;
+        /// @brief The moves leading from the solved position to a win, if SOLVED.
+        std::vector<Move> solution;
+        /// @brief How many positions the search expanded.
+        std::uint64_t nodes = 0;
+        std::chrono::microseconds elapsed {0};
+    };
+
+    /**
+     * @brief A set of position hashes with a fixed capacity, allocated once.
+     * Uses open addressing with linear probing; it never evicts, so it reports
+     * being full instead once it reaches its maximum load.
+     */
+    class TranspositionTable {
+        std::vector<std::uint64_t> slots; // 0 marks an empty slot
+        std::size_t mask;
+        std::size_t used = 0;
+        std::size_t maxUsed;
+
+    public:
+        enum class InsertResult {
+            INSERTED,
+            PRESENT,
+            FULL
+        };
+
+        /// @param bits The table has 2^bits slots.
+        explicit TranspositionTable(unsigned bits);
+
+        /**
+         * @brief Adds a position to the table.
+         * @param hash The Zobrist hash of the position.
+         * @return INSERTED if it was new, PRESENT if it was already there, FULL if it could not be added.
+         */
+        InsertResult insert(std::uint64_t hash) noexcept;
+
+        /// @brief Removes every position from the table, keeping its memory.
+        void clear() noexcept;
+
+        /// @brief Gets how many positions are in the table.
+        std::size_t size() const noexcept;
+    };
+
+    /**
+     * @brief Replaces the single stock turn with the jumps from Game::generateStockJumps,
+     * so a search never stops on a waste card it cannot play.
+     * @param game The position the moves were generated for.
+     * @param moves The moves from Game::generateMoves; changed in place.
+     */
+    void expandStockTurns(const Game& game, MoveBuffer& moves) noexcept;
+
+    /**
+     * @brief Sorts moves so the most promising come first, and drops moves that can never help.
+     * When a card can go to its foundation with no possible downside, that move is the only one kept.
+     * @param game The position the moves were generated for.
+     * @param moves The moves from Game::generateMoves; reordered and possibly shortened in place.
+     */
+    void orderMoves(const Game& game, MoveBuffer& moves) noexcept;
+
+    /**
+     * @brief A depth-first Klondike solver.
+     * It plays moves on a private copy of the game with Game::apply and backtracks
+     * with Game::revert, skipping positions already seen through a transposition table
+     * keyed by the Game hash. A Solver can be reused to solve many games, which keeps
+     * its table allocated.
+     */
+    class Solver {
+        SolverLimits limits;
+        TranspositionTable table;
+        std::atomic<bool> cancelled {false};
+
+    public:
+        explicit Solver(SolverLimits limits = SolverLimits());
+
+        /**
+         * @brief Searches for a winning line from the given position.
+         * @param game The position to solve; it is not modified.
+         * @throws std::logic_error If game is holding cards.
+         * @return The outcome of the search.
+         */
+        SolveResult solve(const Game& game);
+
+        /**
+         * @brief Asks a running solve() to stop as soon as possible, from any thread.
+         * The interrupted solve() returns UNKNOWN. The request holds until clearCancel(), so one
+         * made just before solve() starts stops it too.
+         */
+        void cancel() noexcept;
+
+        /// @brief Forgets a cancel() request, letting the next solve() run.
+        void clearCancel() noexcept;
+    };
+
+    /**
+     * @brief A Klondike solver that spreads one search over several threads.
+     *
+     * The game tree is cut into work items, each the subtree below a line of moves from
+     * the start. Every thread owns a deque of items: it takes work from the front of its own
+     * and steals from the back of the others'. While threads are idle, busy ones give away the
+     * untried moves nearest the root of their current search as new items.
+     *
+     * Items are ranked in the order a single-threaded depth-first search would reach them,
+     * and the shared transposition table records which item first claimed each position.
+     * A thread only skips a position claimed by an earlier (or its own) item, or one proven
+     * to lead nowhere, and the winning line of the earliest solved item is returned. The result
+     * is then the same as Solver's, whatever the thread count and however the work happened
+     * to be scheduled, as long as the search finishes within its limits. A search stopped by
+     * them after some item won still returns that item's line, which may be a later one.
+     */
+    class ParallelSolver {
+    public:
+        /**
+         * @brief How many work items one solve() may cut the tree into.
+         * Busy threads stop giving work away once it is reached, so idle ones stay idle.
+         * Items are given away at most once every 1024 nodes per thread, which keeps
+         * searches within the default node limit well below it.
+         */
+        static constexpr std::uint32_t MAX_WORK_ITEMS = 1 << 20;
+
+        /**
+         * @brief Position hashes tagged with the work item that claimed them, shared by all threads.
+         * A position is marked dead once everything reachable from it was searched without a win,
+         * which lets every item skip it. Lock-free; like TranspositionTable it never evicts and
+         * reports being full instead.
+         */
+        class SharedTable {
+        public:
+            static constexpr std::uint32_t NO_OWNER = UINT32_MAX;
+
+            enum class Claim {
+                CLAIMED, // the item owns the position now and should search below it
+                DEAD, // no win can be reached from the position
+                OWN, // the item already had the position
+                EARLIER, // an earlier item has the position
+                FULL // the position could not be added
+            };
+
+        private:
+            enum State : std::uint8_t {
+                OPEN, // its owner is still searching what it leads to
+                UNPROVEN, // searched, but it led somewhere still unsettled
+                DEAD
+            };
+
+            struct Slot {
+                std::atomic<std::uint64_t> hash; // 0 marks an empty slot
+                std::atomic<std::uint32_t> owner;
+                std::atomic<std::uint32_t> order; // when the owner reached it, in its own search
+                std::atomic<std::uint8_t> state;
+            };
+
+            std::unique_ptr<Slot[]> slots;
+            std::size_t mask;
+            std::atomic<std::size_t> used {0};
+            std::size_t maxUsed;
+            // which slots were filled, in order, so clear() need not walk the whole table;
+            // racing inserts can pass maxUsed by a few, which are left out
+            std::unique_ptr<std::uint32_t[]> usedSlots;
+
+            void clearSlot(std::size_t i) noexcept;
+
+        public:
+            /// @param bits The table has 2^bits slots, 27 bytes each with the list of used ones; at most 32.
+            explicit SharedTable(unsigned bits);
+
+            /**
+             * @brief Finds or adds a position and settles which work item owns it.
+             * @param hash The Zobrist hash of the position.
+             * @param item The work item reaching the position.
+             * @param order Stored with the position if item claims it.
+             * @param precedes Called as precedes(a, b) to check if item a comes before item b.
+             * @param slot Set to where the position is kept.
+             */
+            template <typename Precedes>
+            Claim claim(
+                std::uint64_t hash,
+                std::uint32_t item,
+                std::uint32_t order,
+                Precedes&& precedes,
+                std::size_t& slot
+            ) noexcept;
+
+            /**
+             * @brief Gets the order stored by claim() if the position's owner is still searching it.
+             * Only meaningful to the owner.
+             * @return false if the position was already settled.
+             */
+            bool openOrder(std::size_t slot, std::uint32_t& order) const noexcept;
+
+            /**
+             * @brief Records that the owner is done with a position.
+             * @param dead true if no win can be reached from it.
+             */
+            void settle(std::size_t slot, bool dead) noexcept;
+
+            /**
+             * @brief Removes every position from the table; no thread may be using it.
+             * Only walks the slots that were used, unless more were used than could be listed.
+             */
+            void clear() noexcept;
+        };
+
+    private:
+        struct WorkItem;
+        struct WorkQueue;
+        struct Search;
+
+        SolverLimits limits;
+        unsigned threads;
+        SharedTable table;
+        std::atomic<bool> cancelled {false};
+
+        void work(Search& search, unsigned worker);
+
+    public:
+        /**
+         * @param limits Limits shared by all threads; maxNodes counts nodes across all of them.
+         * @param threads How many threads to search with, 0 for one per hardware thread.
+         */
+        explicit ParallelSolver(SolverLimits limits = SolverLimits(), unsigned threads = 0);
+
+        /**
+         * @brief Searches for a winning line from the given position, blocking until done.
+         * @param game The position to solve; it is not modified.
+         * @throws std::logic_error If game is holding cards.
+         * @return The outcome of the search; nodes counts the nodes of every thread.
+         */
+        SolveResult solve(const Game& game);
+
+        /**
+         * @brief Asks a running solve() to stop as soon as possible, from any thread.
+         * The interrupted solve() returns UNKNOWN, or SOLVED if it had already found a line.
+         * The request is forgotten when the next solve() starts.
+         */
+        void cancel() noexcept;
+
+        /// @brief Gets how many threads solve() searches with.
+        unsigned threadCount() const noexcept;
+    };
+}
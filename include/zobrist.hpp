@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "card.hpp"
+#include "sltrules.hpp"
+
+namespace solitaire::zobrist {
+    // Every pile of a Game gets an index, in this order.
+    constexpr std::size_t STOCK = 0;
+    constexpr std::size_t WASTE = 1;
+    constexpr std::size_t FIRST_FOUNDATION = 2;
+    constexpr std::size_t FIRST_OPEN_TABLEAU = FIRST_FOUNDATION + static_cast<std::size_t>(Suit::COUNT);
+    constexpr std::size_t FIRST_CLOSED_TABLEAU = FIRST_OPEN_TABLEAU + NUM_TABLEAUS;
+    constexpr std::size_t PILE_COUNT = FIRST_CLOSED_TABLEAU + NUM_TABLEAUS;
+
+    /// @brief How many distinct depths each kind of pile is keyed with.
+    /// Foundations and open tableaus can only be ordered one way, so a card's depth
+    /// in them carries no information; the stock, waste and closed tableaus keep
+    /// whatever order the deal gave them.
+    constexpr std::size_t TALON_DEPTHS = Card::DECK_SIZE - NUM_TABLEAUS * (NUM_TABLEAUS + 1) / 2;
+    constexpr std::size_t CLOSED_DEPTHS = NUM_TABLEAUS - 1;
+
+    constexpr std::size_t depthsOf(std::size_t pile) noexcept {
+        if (pile < FIRST_FOUNDATION) return TALON_DEPTHS;
+        if (pile < FIRST_CLOSED_TABLEAU) return 1;
+        return CLOSED_DEPTHS;
+    }
+
+    constexpr std::array<std::size_t, PILE_COUNT + 1> makeOffsets() noexcept {
+        std::array<std::size_t, PILE_COUNT + 1> offsets {};
+        for (std::size_t pile = 0; pile < PILE_COUNT; pile++) {
+            offsets[pile + 1] = offsets[pile] + depthsOf(pile) * Card::DECK_SIZE;
+        }
+        return offsets;
+    }
+
+    /// @brief Where the keys of each pile start in KEYS.
+    constexpr std::array<std::size_t, PILE_COUNT + 1> PILE_OFFSETS = makeOffsets();
+
+    /// @brief One random 64 bit key per (pile, depth, card) triple.
+    extern const std::array<std::uint64_t, PILE_OFFSETS[PILE_COUNT]> KEYS;
+
+    /**
+     * @brief Gets the key of a card lying in a pile.
+     * @param pile The pile index, in [0, PILE_COUNT).
+     * @param depth How many cards lie below it in the pile.
+     * @param card The card.
+     * @return std::uint64_t The key to XOR into the position hash.
+     */
+    inline std::uint64_t key(std::size_t pile, std::size_t depth, Card card) noexcept {
+        std::size_t depths = depthsOf(pile);
+        depth = std::min(depth, depths - 1);
+        return KEYS[PILE_OFFSETS[pile] + depth * Card::DECK_SIZE + card.index()];
+    }
+}
@@ -0,0 +1,87 @@
+#include "assetpack.hpp"
+#include "except.hpp"
+
+#include <cstring>
+
+namespace solitaire {
+    static std::uint32_t readLittleEndian(const unsigned char *in, std::size_t bytes) noexcept {
+        std::uint32_t value = 0;
+        for (std::size_t i = 0; i < bytes; i++) {
+            value |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    static AssetPack::Region readRegion(const unsigned char *entry) noexcept {
+        using assetpack::NAME_SIZE;
+        return {
+            readLittleEndian(entry + NAME_SIZE, 4),
+            readLittleEndian(entry + NAME_SIZE + 4, 4),
+            readLittleEndian(entry + NAME_SIZE + 8, 4),
+            readLittleEndian(entry + NAME_SIZE + 12, 4)
+        };
+    }
+
+    AssetPack::AssetPack(const std::string& path): file(path) {
+        using namespace assetpack;
+        const unsigned char *bytes = this->file.data();
+        std::size_t size = this->file.size();
+        if (size < HEADER_SIZE || std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0) {
+            throw InvalidAssetPackException(path + " is not an asset pack");
+        }
+        if (readLittleEndian(bytes + 8, 2) != VERSION) {
+            throw InvalidAssetPackException(path + " has an unsupported version");
+        }
+        this->regionCount = static_cast<std::uint16_t>(readLittleEndian(bytes + 10, 2));
+        this->width = readLittleEndian(bytes + 12, 4);
+        this->height = readLittleEndian(bytes + 16, 4);
+        std::size_t pixelsOffset = readLittleEndian(bytes + 20, 4);
+
+        std::size_t indexEnd = HEADER_SIZE + this->regionCount * ENTRY_SIZE;
+        std::size_t pixelsSize = std::size_t(this->width) * this->height * BYTES_PER_PIXEL;
+        if (pixelsOffset < indexEnd || pixelsOffset > size || size - pixelsOffset < pixelsSize) {
+            throw InvalidAssetPackException(path + " is truncated");
+        }
+        this->pixels = bytes + pixelsOffset;
+
+        for (std::size_t i = 0; i < this->regionCount; i++) {
+            const unsigned char *entry = bytes + HEADER_SIZE + i * ENTRY_SIZE;
+            Region region = readRegion(entry);
+            if (entry[NAME_SIZE - 1] != '\0'
+                || region.x > this->width || this->width - region.x < region.width
+                || region.y > this->height || this->height - region.y < region.height
+            ) {
+                throw InvalidAssetPackException(path + " has an invalid region");
+            }
+        }
+    }
+
+    bool AssetPack::find(const std::string& name, Region& region) const noexcept {
+        using namespace assetpack;
+        if (name.size() >= NAME_SIZE) {
+            return false;
+        }
+        const unsigned char *bytes = this->file.data();
+        for (std::size_t i = 0; i < this->regionCount; i++) {
+            const unsigned char *entry = bytes + HEADER_SIZE + i * ENTRY_SIZE;
+            // names are null-padded, so comparing the terminator too rules out longer names
+            if (std::memcmp(entry, name.c_str(), name.size() + 1) == 0) {
+                region = readRegion(entry);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::uint32_t AssetPack::atlasWidth() const noexcept {
+        return this->width;
+    }
+
+    std::uint32_t AssetPack::atlasHeight() const noexcept {
+        return this->height;
+    }
+
+    const unsigned char *AssetPack::atlasPixels() const noexcept {
+        return this->pixels;
+    }
+}
@@ -1,6 +1,7 @@
 #include "card.hpp"
 #include "except.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 namespace solitaire {
@@ -48,81 +49,49 @@ namespace solitaire {
         return os << faceToChar(face);
     }
 
-    void CardPile::add(Card *c) noexcept {
-        this->cards.push_front(c);
-    }
-
-    bool CardPile::empty() const noexcept {
-        return this->cards.empty();
-    }
-
-    std::size_t CardPile::size() const noexcept {
-        return this->cards.size();
-    }
-
-
-    const Card *CardPile::peek(std::size_t index) const noexcept {
-        if (this->cards.size() > index) {
-            return this->cards[index];
-        } else {
-            return nullptr;
-        }
-    }
+    void CardPile::moveTopOnto(CardPile& dest, std::size_t amount) {
+        if (amount > this->size()) throw NotEnoughCardsException();
 
-    const Card *CardPile::peekBase() const noexcept {
-        if (this->cards.size() > 0) {
-            return this->cards.back();
-        } else {
-            return nullptr;
-        }
+        this->count -= amount;
+        std::copy_n(this->cards + this->count, amount, dest.cards + dest.count);
+        dest.count += amount;
     }
 
-    CardPile *CardPile::split(std::size_t amount) {
-        auto newPile = new CardPile();
+    void CardPile::turnTopOnto(CardPile& dest, std::size_t amount) {
         if (amount > this->size()) throw NotEnoughCardsException();
 
-        for (std::size_t i = 0; i < amount; i++) {
-            Card *currentTop = this->cards[0];
-            this->cards.pop_front();
-            newPile->cards.push_back(currentTop);
-        }
-
-        return newPile;
+        this->count -= amount;
+        std::reverse_copy(this->cards + this->count, this->cards + this->count + amount, dest.cards + dest.count);
+        dest.count += amount;
     }
 
     void CardPile::stack(CardPile& newTop) noexcept {
-        while (!newTop.empty()) {
-            Card *base = newTop.takeBase();
-            this->add(base);
-        }
+        std::copy_n(newTop.cards, newTop.count, this->cards + this->count);
+        this->count += newTop.count;
+        newTop.count = 0;
     }
 
-    Card *CardPile::takeTop() {
+    Card CardPile::takeTop() {
         if (this->empty()) throw NotEnoughCardsException();
 
-        Card *top = this->cards[0];
-        this->cards.pop_front();
-
-        return top;
+        return this->cards[--this->count];
     }
 
-    Card *CardPile::takeBase() {
+    Card CardPile::takeBase() {
         if (this->empty()) throw NotEnoughCardsException();
 
-        Card *base = this->cards.back();
-        this->cards.pop_back();
+        Card base = this->cards[0];
+        std::copy(this->cards + 1, this->cards + this->count, this->cards);
+        this->count--;
 
         return base;
     }
 
     void CardPile::turnOnto(CardPile& newBase) {
-        for (auto card : *this) {
-            newBase.add(card);
-        }
-        this->cards.clear();
+        this->turnTopOnto(newBase, this->size());
     }
 
     std::ostream& operator<<(std::ostream& os, const Card& card) noexcept {
-        return os << card.face << card.suit;
+        return os << card.face() << card.suit();
     }
 }
@@ -0,0 +1,34 @@
+#include "cputime.hpp"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+namespace solitaire {
+#ifdef _WIN32
+    double processCpuSeconds() noexcept {
+        FILETIME creation, exit, kernel, user;
+        if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+            return 0;
+        }
+        auto ticks = [](const FILETIME& time) {
+            return (static_cast<unsigned long long>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+        };
+        // FILETIME counts 100 nanosecond ticks
+        return (ticks(kernel) + ticks(user)) * 1e-7;
+    }
+#else
+    double processCpuSeconds() noexcept {
+        timespec now;
+        if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now) != 0) {
+            return 0;
+        }
+        return now.tv_sec + now.tv_nsec * 1e-9;
+    }
+#endif
+}
@@ -0,0 +1,195 @@
+#include "dealdatabase.hpp"
+#include "except.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace solitaire {
+    static std::uint32_t readLittleEndian(const unsigned char *in, std::size_t bytes) noexcept {
+        std::uint32_t value = 0;
+        for (std::size_t i = 0; i < bytes; i++) {
+            value |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    static void putLittleEndian(std::string& out, std::uint32_t value, std::size_t bytes) {
+        for (std::size_t i = 0; i < bytes; i++) {
+            out += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    static std::size_t recordsOffset(std::size_t tierCount) noexcept {
+        std::size_t tableEnd = dealdatabase::HEADER_SIZE + 4 * tierCount;
+        return (tableEnd + 7) / 8 * 8;
+    }
+
+    DealDatabase::DealDatabase(const std::string& path): file(path) {
+        using namespace dealdatabase;
+        const unsigned char *bytes = this->file.data();
+        std::size_t size = this->file.size();
+        if (size < HEADER_SIZE || std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0) {
+            throw InvalidDealDatabaseException(path + " is not a deal database");
+        }
+        if (readLittleEndian(bytes + 8, 2) != VERSION || readLittleEndian(bytes + 10, 2) != RECORD_SIZE) {
+            throw InvalidDealDatabaseException(path + " has an unsupported version");
+        }
+        this->drawCount = bytes[12];
+        this->tiers = bytes[13];
+        this->firstSeed = readLittleEndian(bytes + 16, 4);
+        this->seedCount = readLittleEndian(bytes + 20, 4);
+        this->winnableCount = readLittleEndian(bytes + 24, 4);
+        this->nodeLimit = readLittleEndian(bytes + 28, 4);
+        if (this->tiers == 0 || this->tiers > MAX_TIERS || this->winnableCount > this->seedCount
+            || this->seedCount - 1 > std::numeric_limits<std::uint32_t>::max() - this->firstSeed
+        ) {
+            throw InvalidDealDatabaseException(path + " has an invalid header");
+        }
+
+        std::size_t records = recordsOffset(this->tiers);
+        std::size_t winnable = records + std::size_t(this->seedCount) * RECORD_SIZE;
+        if (size < winnable || (size - winnable) / 4 < this->winnableCount) {
+            throw InvalidDealDatabaseException(path + " is truncated");
+        }
+        this->tierTable = bytes + HEADER_SIZE;
+        this->records = bytes + records;
+        this->winnable = bytes + winnable;
+
+        // checking the tier table once lets sampling trust it
+        for (std::size_t tier = 0; tier < this->tiers; tier++) {
+            std::uint32_t end = tier + 1 < this->tiers ? this->tierStart(tier + 1) : this->winnableCount;
+            if (this->tierStart(tier) > end) {
+                throw InvalidDealDatabaseException(path + " has an invalid tier table");
+            }
+        }
+    }
+
+    void DealDatabase::write(
+        const std::string& path,
+        std::uint8_t drawCount,
+        std::uint32_t firstSeed,
+        const std::vector<Deal>& deals,
+        std::size_t tierCount,
+        std::uint32_t nodeLimit
+    ) {
+        using namespace dealdatabase;
+        if (tierCount == 0 || tierCount > MAX_TIERS) {
+            throw std::invalid_argument("The tier count must be from 1 to " + std::to_string(MAX_TIERS));
+        }
+        if (deals.empty() || deals.size() - 1 > std::numeric_limits<std::uint32_t>::max() - firstSeed) {
+            throw std::invalid_argument("The deals must cover a range of seeds within 0 to 4294967295");
+        }
+
+        // the winnable seeds from easiest to hardest, cut into tiers of about equal size
+        std::vector<std::uint32_t> winnable;
+        for (std::size_t i = 0; i < deals.size(); i++) {
+            if (deals[i].status == SolveStatus::SOLVED) {
+                winnable.push_back(static_cast<std::uint32_t>(firstSeed + i));
+            }
+        }
+        std::stable_sort(winnable.begin(), winnable.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return deals[a - firstSeed].difficulty < deals[b - firstSeed].difficulty;
+        });
+        std::vector<std::uint8_t> tierOf(deals.size(), NO_TIER);
+        std::vector<std::uint32_t> starts(tierCount);
+        for (std::size_t tier = 0; tier < tierCount; tier++) {
+            std::size_t start = winnable.size() * tier / tierCount;
+            std::size_t end = winnable.size() * (tier + 1) / tierCount;
+            starts[tier] = static_cast<std::uint32_t>(start);
+            for (std::size_t i = start; i < end; i++) {
+                tierOf[winnable[i] - firstSeed] = static_cast<std::uint8_t>(tier);
+            }
+            std::sort(winnable.begin() + start, winnable.begin() + end);
+        }
+
+        std::string bytes(MAGIC, sizeof(MAGIC));
+        putLittleEndian(bytes, VERSION, 2);
+        putLittleEndian(bytes, RECORD_SIZE, 2);
+        putLittleEndian(bytes, drawCount, 1);
+        putLittleEndian(bytes, static_cast<std::uint32_t>(tierCount), 1);
+        putLittleEndian(bytes, 0, 2);
+        putLittleEndian(bytes, firstSeed, 4);
+        putLittleEndian(bytes, static_cast<std::uint32_t>(deals.size()), 4);
+        putLittleEndian(bytes, static_cast<std::uint32_t>(winnable.size()), 4);
+        putLittleEndian(bytes, nodeLimit, 4);
+        for (std::uint32_t start : starts) {
+            putLittleEndian(bytes, start, 4);
+        }
+        bytes.resize(recordsOffset(tierCount), '\0');
+
+        for (std::size_t i = 0; i < deals.size(); i++) {
+            putLittleEndian(bytes, static_cast<std::uint8_t>(deals[i].status), 1);
+            putLittleEndian(bytes, tierOf[i], 1);
+            putLittleEndian(bytes, deals[i].solutionLength, 2);
+            putLittleEndian(bytes, deals[i].difficulty, 4);
+        }
+        for (std::uint32_t seed : winnable) {
+            putLittleEndian(bytes, seed, 4);
+        }
+
+        std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size());
+        if (!out) {
+            throw std::runtime_error("Cannot write " + path);
+        }
+    }
+
+    std::uint32_t DealDatabase::tierStart(std::size_t tier) const noexcept {
+        return readLittleEndian(this->tierTable + 4 * tier, 4);
+    }
+
+    std::uint32_t DealDatabase::winnableSeed(std::size_t i) const noexcept {
+        return readLittleEndian(this->winnable + 4 * i, 4);
+    }
+
+    bool DealDatabase::contains(std::uint32_t seed) const noexcept {
+        return seed >= this->firstSeed && seed - this->firstSeed < this->seedCount;
+    }
+
+    DealDatabase::Deal DealDatabase::lookup(std::uint32_t seed) const {
+        if (!this->contains(seed)) {
+            throw std::out_of_range("The deal database has no record for seed " + std::to_string(seed));
+        }
+        const unsigned char *record = this->records + std::size_t(seed - this->firstSeed) * dealdatabase::RECORD_SIZE;
+        return {
+            static_cast<SolveStatus>(record[0]),
+            record[1],
+            static_cast<std::uint16_t>(readLittleEndian(record + 2, 2)),
+            readLittleEndian(record + 4, 4)
+        };
+    }
+
+    std::uint8_t DealDatabase::getDrawCount() const noexcept {
+        return this->drawCount;
+    }
+
+    std::uint32_t DealDatabase::getFirstSeed() const noexcept {
+        return this->firstSeed;
+    }
+
+    std::uint32_t DealDatabase::getSeedCount() const noexcept {
+        return this->seedCount;
+    }
+
+    std::uint32_t DealDatabase::getWinnableCount() const noexcept {
+        return this->winnableCount;
+    }
+
+    std::uint32_t DealDatabase::getNodeLimit() const noexcept {
+        return this->nodeLimit;
+    }
+
+    std::size_t DealDatabase::getTierCount() const noexcept {
+        return this->tiers;
+    }
+
+    std::size_t DealDatabase::getTierSize(std::size_t tier) const {
+        if (tier >= this->tiers) {
+            throw std::out_of_range("The deal database has no tier " + std::to_string(tier));
+        }
+        std::uint32_t end = tier + 1 < this->tiers ? this->tierStart(tier + 1) : this->winnableCount;
+        return end - this->tierStart(tier);
+    }
+}
@@ -0,0 +1,201 @@
+#include "frameprofiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace solitaire {
+    FramePhase& operator++(FramePhase& phase) {
+        phase = static_cast<FramePhase>(static_cast<int>(phase) + 1);
+        if (phase > FramePhase::END) phase = FramePhase::FIRST;
+        return phase;
+    }
+
+    FramePhase operator++(FramePhase& phase, int) {
+        FramePhase result(phase);
+        ++phase;
+        return result;
+    }
+
+    const char *framePhaseToString(FramePhase phase) {
+        switch (phase) {
+            case FramePhase::INPUT: return "input";
+            case FramePhase::UPDATE: return "update";
+            case FramePhase::RENDER: return "render";
+            case FramePhase::PRESENT: return "present";
+            default: return "?";
+        }
+    }
+
+    namespace {
+        // the value at fraction p of sorted, which must not be empty
+        double nearestRank(const std::vector<float>& sorted, double p) {
+            std::size_t rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+            return sorted[std::max<std::size_t>(rank, 1) - 1];
+        }
+    }
+
+    void FrameProfiler::Histogram::add(double milliseconds) {
+        std::size_t bucket = static_cast<std::size_t>(milliseconds / BUCKET_MS);
+        this->counts[std::min(bucket, BUCKETS - 1)]++;
+        this->sum += milliseconds;
+        this->max = std::max(this->max, milliseconds);
+    }
+
+    FrameProfiler::Percentiles FrameProfiler::Histogram::percentiles() const {
+        std::uint64_t total = 0;
+        for (std::uint64_t count : this->counts) {
+            total += count;
+        }
+        auto at = [&](double p) {
+            std::uint64_t rank = std::max<std::uint64_t>(static_cast<std::uint64_t>(std::ceil(p * total)), 1);
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < BUCKETS - 1; i++) {
+                seen += this->counts[i];
+                if (seen >= rank) {
+                    return std::min((i + 1) * BUCKET_MS, this->max);
+                }
+            }
+            return this->max;
+        };
+        if (total == 0) {
+            return {0, 0, 0, 0};
+        }
+        return {at(0.50), at(0.95), at(0.99), this->max};
+    }
+
+    void FrameProfiler::endPhase(Clock::time_point now) {
+        this->current.milliseconds[this->currentPhase] +=
+            std::chrono::duration<float, std::milli>(now - this->phaseStart).count();
+        this->phaseStart = now;
+    }
+
+    void FrameProfiler::beginFrame() {
+        this->current = Frame {};
+        this->currentPhase = FramePhase::INPUT;
+        this->boundTexture = 0;
+        this->phaseStart = Clock::now();
+    }
+
+    void FrameProfiler::beginPhase(FramePhase phase) {
+        this->endPhase(Clock::now());
+        this->currentPhase = phase;
+    }
+
+    void FrameProfiler::endFrame(bool keep) {
+        this->endPhase(Clock::now());
+        if (!keep) {
+            return;
+        }
+
+        Frame& frame = this->current;
+        frame.totalMilliseconds = 0;
+        for (FramePhase phase = FramePhase::FIRST; phase < FramePhase::END; phase++) {
+            frame.totalMilliseconds += frame.milliseconds[phase];
+            this->phaseHistograms[phase].add(frame.milliseconds[phase]);
+        }
+        this->frameHistogram.add(frame.totalMilliseconds);
+        if (frame.handledInput) {
+            this->inputHistogram.add(frame.totalMilliseconds);
+            this->sessionInputFrames++;
+        }
+        this->sessionFrames++;
+        this->sessionDrawCalls += frame.drawCalls;
+        this->sessionTextureBinds += frame.textureBinds;
+        this->maxDrawCalls = std::max(this->maxDrawCalls, frame.drawCalls);
+        this->maxTextureBinds = std::max(this->maxTextureBinds, frame.textureBinds);
+
+        this->history[this->nextFrame] = frame;
+        this->nextFrame = (this->nextFrame + 1) % HISTORY;
+        this->recorded = std::min(this->recorded + 1, HISTORY);
+    }
+
+    void FrameProfiler::countDraw(unsigned textureId) {
+        this->current.drawCalls++;
+        if (textureId != this->boundTexture) {
+            this->current.textureBinds++;
+            this->boundTexture = textureId;
+        }
+    }
+
+    void FrameProfiler::markInputHandled() {
+        this->current.handledInput = true;
+    }
+
+    std::size_t FrameProfiler::recentFrames() const {
+        return this->recorded;
+    }
+
+    const FrameProfiler::Frame& FrameProfiler::recentFrame(std::size_t i) const {
+        return this->history[(this->nextFrame + HISTORY - this->recorded + i) % HISTORY];
+    }
+
+    template <typename Select>
+    FrameProfiler::Percentiles FrameProfiler::recentPercentiles(Select select) const {
+        if (this->recorded == 0) {
+            return {0, 0, 0, 0};
+        }
+        std::vector<float> sorted;
+        sorted.reserve(this->recorded);
+        for (std::size_t i = 0; i < this->recorded; i++) {
+            if (select(this->history[i]) >= 0) {
+                sorted.push_back(select(this->history[i]));
+            }
+        }
+        if (sorted.empty()) {
+            return {0, 0, 0, 0};
+        }
+        std::sort(sorted.begin(), sorted.end());
+        return {nearestRank(sorted, 0.50), nearestRank(sorted, 0.95), nearestRank(sorted, 0.99), sorted.back()};
+    }
+
+    FrameProfiler::Percentiles FrameProfiler::recentPercentiles(FramePhase phase) const {
+        return this->recentPercentiles([phase](const Frame& frame) { return frame.milliseconds[phase]; });
+    }
+
+    FrameProfiler::Percentiles FrameProfiler::recentFramePercentiles() const {
+        return this->recentPercentiles([](const Frame& frame) { return frame.totalMilliseconds; });
+    }
+
+    FrameProfiler::Percentiles FrameProfiler::recentInputPercentiles() const {
+        // frames selected as negative are left out
+        return this->recentPercentiles([](const Frame& frame) {
+            return frame.handledInput ? frame.totalMilliseconds : -1.0f;
+        });
+    }
+
+    void FrameProfiler::writeReport(std::ostream& out) const {
+        out << "frames: " << this->sessionFrames << '\n';
+        if (this->sessionFrames == 0) {
+            return;
+        }
+
+        auto writeRow = [&out](const char *name, const Histogram& histogram, std::uint64_t frames) {
+            Percentiles p = histogram.percentiles();
+            out << name << ": mean " << histogram.sum / frames
+                << " ms, p50 " << p.p50 << " ms, p95 " << p.p95
+                << " ms, p99 " << p.p99 << " ms, max " << p.max << " ms\n";
+        };
+        writeRow("frame", this->frameHistogram, this->sessionFrames);
+        for (FramePhase phase = FramePhase::FIRST; phase < FramePhase::END; phase++) {
+            writeRow(framePhaseToString(phase), this->phaseHistograms[phase], this->sessionFrames);
+        }
+        out << "frames that handled input: " << this->sessionInputFrames << '\n';
+        if (this->sessionInputFrames != 0) {
+            // from handling the input to EndDrawing returning; the compositor and display add more
+            writeRow("handled-to-present", this->inputHistogram, this->sessionInputFrames);
+        }
+        out << "draw calls per frame: mean " << double(this->sessionDrawCalls) / this->sessionFrames
+            << ", max " << this->maxDrawCalls << '\n';
+        out << "texture binds per frame: mean " << double(this->sessionTextureBinds) / this->sessionFrames
+            << ", max " << this->maxTextureBinds << '\n';
+
+        out << "\nframe time histogram (bucket start in ms, frames):\n";
+        const std::array<std::uint64_t, BUCKETS>& counts = this->frameHistogram.counts;
+        for (std::size_t i = 0; i < BUCKETS; i++) {
+            if (counts[i] != 0) {
+                out << i * BUCKET_MS << (i == BUCKETS - 1 ? "+" : "") << '\t' << counts[i] << '\n';
+            }
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#include "hintengine.hpp"
+
+#include <cstring>
+
+namespace solitaire {
+    static_assert(sizeof(Move) == 4, "a Move must fit the published word next to the generation and status");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "hints are handed over without locking");
+
+    static constexpr std::uint32_t GENERATION_MASK = 0xFFFFFF;
+
+    HintEngine::HintEngine(std::chrono::milliseconds budget):
+        solver([budget] {
+            SolverLimits limits;
+            limits.maxNodes = 0;
+            limits.maxTime = budget;
+            limits.tableBits = 20;
+            return limits;
+        }()),
+        worker(&HintEngine::work, this) {}
+
+    HintEngine::~HintEngine() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stopping = true;
+        }
+        this->solver.cancel();
+        this->wake.notify_one();
+        this->worker.join();
+    }
+
+    std::uint64_t HintEngine::pack(std::uint32_t generation, HintStatus status, Move move) noexcept {
+        std::uint32_t moveBits;
+        std::memcpy(&moveBits, &move, sizeof(moveBits));
+        return std::uint64_t(generation & GENERATION_MASK) << 40
+            | std::uint64_t(static_cast<std::uint8_t>(status)) << 32
+            | moveBits;
+    }
+
+    void HintEngine::submit(const Game& game) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->pending = game;
+            this->submitted++;
+            this->latestGeneration.store(this->submitted, std::memory_order_release);
+        }
+        // the search under way is for an older position now; the worker clears the flag under the
+        // mutex as it takes a copy, so the cancel either stops an older search or finds nothing to stop
+        this->solver.cancel();
+        this->wake.notify_one();
+    }
+
+    HintStatus HintEngine::latest(Move& move) const noexcept {
+        std::uint64_t word = this->published.load(std::memory_order_acquire);
+        std::uint32_t generation = this->latestGeneration.load(std::memory_order_acquire);
+        if ((word >> 40) != (generation & GENERATION_MASK)) {
+            return HintStatus::PENDING;
+        }
+        std::uint32_t moveBits = static_cast<std::uint32_t>(word);
+        std::memcpy(&move, &moveBits, sizeof(move));
+        return static_cast<HintStatus>((word >> 32) & 0xFF);
+    }
+
+    void HintEngine::work() {
+        std::uint32_t taken = 0;
+        std::unique_lock<std::mutex> lock(this->mutex);
+        while (true) {
+            this->wake.wait(lock, [&] { return this->stopping || this->submitted != taken; });
+            if (this->stopping) {
+                return;
+            }
+            this->solver.clearCancel();
+            Game game = *this->pending;
+            taken = this->submitted;
+            lock.unlock();
+
+            HintStatus status = HintStatus::NO_WIN;
+            Move move {};
+            if (game.isWon()) {
+                status = HintStatus::WON; // solve() would call it solved, with no move to show
+            } else {
+                SolveResult result = this->solver.solve(game);
+                if (result.status == SolveStatus::SOLVED && !result.solution.empty()) {
+                    status = HintStatus::WINNING;
+                    move = result.solution.front();
+                } else if (result.status == SolveStatus::UNKNOWN) {
+                    MoveBuffer moves;
+                    game.generateMoves(moves);
+                    expandStockTurns(game, moves); // like the search, so a stock hint reaches a playable card
+                    orderMoves(game, moves);
+                    if (!moves.empty()) {
+                        status = HintStatus::PROMISING;
+                        move = moves[0];
+                    }
+                }
+            }
+            // published even if stale: latest() tells by the generation
+            this->published.store(pack(taken, status, move), std::memory_order_release);
+
+            lock.lock();
+        }
+    }
+}
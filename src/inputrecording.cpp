@@ -0,0 +1,169 @@
+#include "inputrecording.hpp"
+#include "except.hpp"
+#include "mappedfile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace solitaire {
+    static bool hasPosition(InputEventType type) noexcept {
+        return type == InputEventType::PRESS || type == InputEventType::DRAG || type == InputEventType::RELEASE;
+    }
+
+    static void putLittleEndian(std::string& out, std::uint32_t value, std::size_t bytes) {
+        for (std::size_t i = 0; i < bytes; i++) {
+            out += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    static std::uint32_t readLittleEndian(const unsigned char *in, std::size_t bytes) noexcept {
+        std::uint32_t value = 0;
+        for (std::size_t i = 0; i < bytes; i++) {
+            value |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    static void putFloat(std::string& out, float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putLittleEndian(out, bits, 4);
+    }
+
+    static float readFloat(const unsigned char *in) noexcept {
+        std::uint32_t bits = readLittleEndian(in, 4);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    InputRecording::InputRecording(std::uint32_t seed, std::uint8_t drawCount, std::uint16_t cardWidth, std::uint16_t cardHeight):
+        seed(seed),
+        drawCount(drawCount),
+        cardWidth(cardWidth),
+        cardHeight(cardHeight) {}
+
+    double InputRecording::add(InputEventType type, double time, float x, float y) {
+        if (this->events.empty()) {
+            this->startTime = time;
+        }
+        double sinceStart = std::max(time - this->startTime, 0.0);
+        std::uint64_t microseconds = std::max(static_cast<std::uint64_t>(std::llround(sinceStart * 1e6)), this->lastMicroseconds);
+        this->lastMicroseconds = microseconds;
+
+        double recorded = microseconds / 1e6;
+        this->events.push_back({type, recorded, x, y});
+        return recorded;
+    }
+
+    void InputRecording::save(const std::string& path) const {
+        using namespace inputrecording;
+        std::string bytes(MAGIC, sizeof(MAGIC));
+        putLittleEndian(bytes, VERSION, 2);
+        putLittleEndian(bytes, this->drawCount, 1);
+        putLittleEndian(bytes, 0, 1);
+        putLittleEndian(bytes, this->seed, 4);
+        putLittleEndian(bytes, this->cardWidth, 2);
+        putLittleEndian(bytes, this->cardHeight, 2);
+
+        std::uint64_t previous = 0;
+        for (const InputEvent& event : this->events) {
+            bytes += static_cast<char>(event.type);
+            std::uint64_t microseconds = static_cast<std::uint64_t>(std::llround(event.time * 1e6));
+            std::uint64_t delta = microseconds - previous;
+            previous = microseconds;
+            do {
+                bytes += static_cast<char>((delta & 0x7F) | (delta > 0x7F ? 0x80 : 0));
+                delta >>= 7;
+            } while (delta != 0);
+            if (hasPosition(event.type)) {
+                putFloat(bytes, event.x);
+                putFloat(bytes, event.y);
+            }
+        }
+
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(bytes.data(), bytes.size());
+        if (!file) {
+            throw std::runtime_error("Cannot write " + path);
+        }
+    }
+
+    InputRecording InputRecording::load(const std::string& path) {
+        using namespace inputrecording;
+        MappedFile file(path);
+        const unsigned char *bytes = file.data();
+        std::size_t size = file.size();
+        if (size < HEADER_SIZE || std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0) {
+            throw InvalidRecordingException(path + " is not an input recording");
+        }
+        if (readLittleEndian(bytes + 8, 2) != VERSION) {
+            throw InvalidRecordingException(path + " has an unsupported version");
+        }
+        InputRecording recording(
+            readLittleEndian(bytes + 12, 4),
+            static_cast<std::uint8_t>(bytes[10]),
+            static_cast<std::uint16_t>(readLittleEndian(bytes + 16, 2)),
+            static_cast<std::uint16_t>(readLittleEndian(bytes + 18, 2))
+        );
+        if (recording.drawCount != 1 && recording.drawCount != 3) {
+            throw InvalidRecordingException(path + " has an invalid draw count");
+        }
+
+        std::uint64_t microseconds = 0;
+        std::size_t at = HEADER_SIZE;
+        while (at < size) {
+            InputEventType type = static_cast<InputEventType>(bytes[at++]);
+            if (type >= InputEventType::END) {
+                throw InvalidRecordingException(path + " has an invalid event");
+            }
+            std::uint64_t delta = 0;
+            unsigned shift = 0;
+            bool more = true;
+            while (more) {
+                if (at == size || shift > 56) {
+                    throw InvalidRecordingException(path + " is truncated");
+                }
+                delta |= std::uint64_t(bytes[at] & 0x7F) << shift;
+                more = (bytes[at++] & 0x80) != 0;
+                shift += 7;
+            }
+            microseconds += delta;
+
+            InputEvent event {type, microseconds / 1e6, 0, 0};
+            if (hasPosition(type)) {
+                if (size - at < 8) {
+                    throw InvalidRecordingException(path + " is truncated");
+                }
+                event.x = readFloat(bytes + at);
+                event.y = readFloat(bytes + at + 4);
+                at += 8;
+            }
+            recording.events.push_back(event);
+        }
+        recording.lastMicroseconds = microseconds;
+        return recording;
+    }
+
+    std::uint32_t InputRecording::getSeed() const noexcept {
+        return this->seed;
+    }
+
+    std::uint8_t InputRecording::getDrawCount() const noexcept {
+        return this->drawCount;
+    }
+
+    std::uint16_t InputRecording::getCardWidth() const noexcept {
+        return this->cardWidth;
+    }
+
+    std::uint16_t InputRecording::getCardHeight() const noexcept {
+        return this->cardHeight;
+    }
+
+    const std::vector<InputEvent>& InputRecording::getEvents() const noexcept {
+        return this->events;
+    }
+}
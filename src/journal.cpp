@@ -0,0 +1,49 @@
+#include "journal.hpp"
+#include "slt.hpp"
+
+namespace solitaire {
+    void MoveJournal::record(const MoveRecord& record) {
+        if (record.empty()) {
+            return;
+        }
+        this->records.resize(this->played);
+        this->records.push_back(record);
+        this->played++;
+    }
+
+    bool MoveJournal::canUndo() const noexcept {
+        return this->played > 0;
+    }
+
+    bool MoveJournal::canRedo() const noexcept {
+        return this->played < this->records.size();
+    }
+
+    bool MoveJournal::undo(Game& game) noexcept {
+        if (!this->canUndo()) {
+            return false;
+        }
+        this->played--;
+        game.revert(this->records[this->played]);
+        return true;
+    }
+
+    bool MoveJournal::redo(Game& game) noexcept {
+        if (!this->canRedo()) {
+            return false;
+        }
+        // replaying may flip a closed card differently if the autoplay options changed meanwhile
+        this->records[this->played] = game.apply(this->records[this->played].move);
+        this->played++;
+        return true;
+    }
+
+    void MoveJournal::clear() noexcept {
+        this->records.clear();
+        this->played = 0;
+    }
+
+    std::size_t MoveJournal::size() const noexcept {
+        return this->played;
+    }
+}
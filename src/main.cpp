@@ -4,7 +4,14 @@
 #include <memory>
 #include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
 
+#include "cputime.hpp"
+#include "dealdatabase.hpp"
+#include "options.hpp"
 #include "sltgraphics.hpp"
 
 using namespace solitaire;
@@ -17,37 +24,192 @@ int secondsSinceEpoch() {
     return now.time_since_epoch().count() * n / d;
 }
 
-int main() {
+// a seed as the options ask for: any deal, or a winnable one from the deal database
+std::uint32_t chooseSeed() {
+    std::uint32_t seed = secondsSinceEpoch();
+    if (!config::winnableDealsOnly && config::dealTier < 0) {
+        return seed;
+    }
+    try {
+        DealDatabase deals(DEAL_DATABASE_PATH);
+        std::size_t drawCount = config::stockDraw == config::wasteDifficulty::THREE ? 3 : 1;
+        if (deals.getDrawCount() != drawCount) {
+            throw std::runtime_error(std::string(DEAL_DATABASE_PATH) + " was solved with another draw count");
+        }
+        std::minstd_rand rand(seed);
+        return config::dealTier < 0 ? deals.sampleWinnable(rand) : deals.sampleTier(config::dealTier, rand);
+    } catch (const std::exception& e) {
+        cerr << "Could not pick a winnable deal: " << e.what() << endl;
+        cerr << "Dealing any game instead; run `make deals` to build the deal database." << endl;
+        return seed;
+    }
+}
+
+// plays a recording back repeat times without a window, as fast as the input handling goes
+int replay(const char *path, long repeat) {
+    try {
+        InputRecording recording = InputRecording::load(path);
+        std::unique_ptr<GraphicalGame> game;
+        auto started = std::chrono::steady_clock::now();
+        for (long i = 0; i < repeat; i++) {
+            game = GraphicalGame::createForReplay(recording);
+            game->replay(recording);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        std::size_t events = recording.getEvents().size();
+        cerr << "Replayed seed " << recording.getSeed() << ", " << events << " events, " << repeat << " times in "
+            << seconds << " s (" << repeat / std::max(seconds, 1e-9) << " games/s, "
+            << repeat * events / std::max(seconds, 1e-9) << " events/s)" << endl;
+        cerr << "Ended after " << game->getGame().getMoveCount() << " moves, "
+            << (game->getGame().isWon() ? "won" : "not won") << endl;
+    } catch (const std::exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 3 && std::strcmp(argv[1], "--replay") == 0) {
+        long repeat = argc >= 5 && std::strcmp(argv[3], "--repeat") == 0 ? std::atol(argv[4]) : 1;
+        return replay(argv[2], std::max(repeat, 1L));
+    }
+
+    auto started = std::chrono::steady_clock::now();
     InitWindow(TARGET_RESOLUTION.x, TARGET_RESOLUTION.y, "Solitaire");
-    SetTargetFPS(60);
+    // draw as often as the display can show frames, so drags keep up at any refresh rate
+    int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    SetTargetFPS(refreshRate > 0 ? refreshRate : 60);
 
     try {
-        GraphicalGame game(secondsSinceEpoch());
+        std::unique_ptr<GraphicalGame> played;
+        if (config::savePath[0] != '\0') {
+            try {
+                played = GraphicalGame::resume(config::savePath);
+            } catch (const std::exception& e) {
+                cerr << "Could not resume the saved game: " << e.what() << endl;
+            }
+        }
+        if (!played) {
+            played = std::make_unique<GraphicalGame>(chooseSeed());
+        }
+        GraphicalGame& game = *played;
+        bool firstFrame = true;
+        bool waitingForEvents = false;
+
+        // time spent in frames with nothing being dragged, to see what idling costs
+        double idleSeconds = 0;
+        double idleCpuSeconds = 0;
+
+        FrameProfiler& profiler = game.getProfiler();
 
         while (!WindowShouldClose()) {
+            profiler.beginFrame();
+            auto frameStart = std::chrono::steady_clock::now();
+            double frameCpuStart = processCpuSeconds();
 
+            // EndDrawing polled this input at the end of the last frame. Handling it before drawing shows
+            // it no sooner than handling it after, but lets this frame stop waiting for events first.
+            // inputTime is when the input is handled, not when it happened.
+            double inputTime = GetTime();
+            auto mousePos = GetMousePosition();
+            bool hadInput = false;
+            if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+                game.handleMousePress(mousePos, inputTime);
+                hadInput = true;
+            }
+            if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
+                Vector2 delta = GetMouseDelta();
+                hadInput = hadInput || delta.x != 0 || delta.y != 0;
+                game.handleDrag(mousePos, inputTime);
+            }
+            if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
+                game.handleMouseRelease(mousePos, inputTime);
+                hadInput = true;
+            }
+
+            bool ctrlDown = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+            if (ctrlDown && IsKeyPressed(KEY_Z)) {
+                game.undo(inputTime);
+                hadInput = true;
+            }
+            if (ctrlDown && IsKeyPressed(KEY_Y)) {
+                game.redo(inputTime);
+                hadInput = true;
+            }
+            if (IsKeyPressed(KEY_H)) {
+                game.requestHint();
+                hadInput = true;
+            }
+            if (IsKeyPressed(KEY_F3)) {
+                game.toggleProfilerOverlay();
+                hadInput = true;
+            }
+
+            if (hadInput) {
+                // the frame began with the input, so its length up to EndDrawing returning is handled-to-present
+                profiler.markInputHandled();
+            }
+
+            // with event waiting on, EndDrawing blocks until there is input to handle;
+            // a frame answering input must not, or it would wait before it is shown
+            bool idle = !hadInput && !game.isDragging() && !game.isProfilerOverlayShown() && !game.isWaitingForHint();
+            if (waitingForEvents && !idle) {
+                DisableEventWaiting();
+                waitingForEvents = false;
+            }
+
+            profiler.beginPhase(FramePhase::UPDATE);
             game.update();
 
+            profiler.beginPhase(FramePhase::RENDER);
             BeginDrawing();
                 ClearBackground(BACKGROUND_COLOR);
                 game.render();
+            profiler.beginPhase(FramePhase::PRESENT);
             EndDrawing();
+            // a frame that slept in EndDrawing until the next event would only measure the wait
+            profiler.endFrame(!waitingForEvents);
 
-            auto mousePos = GetMousePosition();
-            if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-                game.handleMousePress(mousePos);
+            if (firstFrame) {
+                auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started);
+                cerr << "Time to first frame: " << elapsed.count() << " ms" << endl;
+                firstFrame = false;
             }
-            if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
-                game.handleDrag(mousePos);
+
+            if (idle) {
+                idleSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count();
+                idleCpuSeconds += processCpuSeconds() - frameCpuStart;
             }
-            if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
-                game.handleMouseRelease(mousePos);
+            bool needsFrames = game.isDragging() || game.isProfilerOverlayShown() || game.isWaitingForHint();
+            if (config::waitForEventsWhenIdle && !waitingForEvents && !needsFrames) {
+                EnableEventWaiting();
+                waitingForEvents = true;
+            }
+        }
+
+        if (idleSeconds > 0) {
+            cerr << "Idle for " << idleSeconds << " s, using "
+                << idleCpuSeconds / idleSeconds * 60 * 1000 << " ms of CPU time per idle minute ("
+                << (config::waitForEventsWhenIdle ? "waiting for events" : "redrawing every frame") << ")" << endl;
+        }
+        if (config::frameProfilePath[0] != '\0') {
+            std::ofstream report(config::frameProfilePath);
+            profiler.writeReport(report);
+            if (!report) {
+                cerr << "Could not write the frame profile to " << config::frameProfilePath << endl;
             }
         }
+        if (config::inputRecordingPath[0] != '\0' && game.getRecording() != nullptr) {
+            game.getRecording()->save(config::inputRecordingPath);
+        }
+        if (config::savePath[0] != '\0') {
+            game.save(config::savePath);
+        }
     } catch (const std::exception& e) {
         cerr << e.what() << endl;
     }
     // must deinit game while window is still open
     CloseWindow();
     return 0;
-}
\ No newline at end of file
+}
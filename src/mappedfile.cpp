@@ -0,0 +1,132 @@
+#include "mappedfile.hpp"
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace solitaire {
+#ifdef _WIN32
+    static std::system_error lastError(const std::string& what) {
+        return std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+    }
+
+    MappedFile::MappedFile(const std::string& path) {
+        HANDLE file = CreateFileA(
+            path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+        );
+        if (file == INVALID_HANDLE_VALUE) {
+            throw lastError("Cannot open " + path);
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            std::system_error error = lastError("Cannot get the size of " + path);
+            CloseHandle(file);
+            throw error;
+        }
+        if (size.QuadPart == 0) {
+            // empty files cannot be mapped
+            CloseHandle(file);
+            return;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr) {
+            throw lastError("Cannot map " + path);
+        }
+        // the view keeps the mapping object alive on its own
+        void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (view == nullptr) {
+            throw lastError("Cannot map " + path);
+        }
+        this->bytes = static_cast<const unsigned char *>(view);
+        this->length = static_cast<std::size_t>(size.QuadPart);
+    }
+
+    void MappedFile::unmap() noexcept {
+        if (this->bytes != nullptr) {
+            UnmapViewOfFile(this->bytes);
+        }
+        this->bytes = nullptr;
+        this->length = 0;
+    }
+#else
+    static std::system_error lastError(const std::string& what) {
+        return std::system_error(errno, std::generic_category(), what);
+    }
+
+    MappedFile::MappedFile(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw lastError("Cannot open " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            std::system_error error = lastError("Cannot get the size of " + path);
+            close(fd);
+            throw error;
+        }
+        if (info.st_size == 0) {
+            // empty files cannot be mapped
+            close(fd);
+            return;
+        }
+
+        void *view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping keeps its own reference to the file
+        close(fd);
+        if (view == MAP_FAILED) {
+            throw lastError("Cannot map " + path);
+        }
+        this->bytes = static_cast<const unsigned char *>(view);
+        this->length = static_cast<std::size_t>(info.st_size);
+    }
+
+    void MappedFile::unmap() noexcept {
+        if (this->bytes != nullptr) {
+            munmap(const_cast<unsigned char *>(this->bytes), this->length);
+        }
+        this->bytes = nullptr;
+        this->length = 0;
+    }
+#endif
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept:
+        bytes(std::exchange(other.bytes, nullptr)),
+        length(std::exchange(other.length, 0)) {}
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            this->unmap();
+            this->bytes = std::exchange(other.bytes, nullptr);
+            this->length = std::exchange(other.length, 0);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        this->unmap();
+    }
+
+    const unsigned char *MappedFile::data() const noexcept {
+        return this->bytes;
+    }
+
+    std::size_t MappedFile::size() const noexcept {
+        return this->length;
+    }
+}
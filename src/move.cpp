@@ -0,0 +1,133 @@
+#include "move.hpp"
+#include "slt.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace solitaire {
+    std::ostream& operator<<(std::ostream& os, const Move& move) noexcept {
+        int from = move.from;
+        int to = move.to;
+        switch (move.type) {
+            case MoveType::TURN_STOCK:
+                os << "s>w";
+                break;
+            case MoveType::RECYCLE_WASTE:
+                return os << "w>s";
+            case MoveType::WASTE_TO_TABLEAU:
+                return os << "w>t" << to;
+            case MoveType::WASTE_TO_FOUNDATION:
+                return os << "w>f";
+            case MoveType::TABLEAU_TO_TABLEAU:
+                os << 't' << from << ">t" << to;
+                break;
+            case MoveType::TABLEAU_TO_FOUNDATION:
+                return os << 't' << from << ">f";
+            case MoveType::FOUNDATION_TO_TABLEAU:
+                return os << 'f' << static_cast<Suit>(move.from) << ">t" << to;
+            case MoveType::TURN_CLOSED_TABLEAU:
+                return os << "flip t" << from;
+        }
+        if (move.count > 1) {
+            os << 'x' << static_cast<int>(move.count);
+        }
+        return os;
+    }
+
+    /**
+     * @brief Finds how many cards from the top of source can be moved onto dest.
+     * Open tableaus are runs of alternating, descending faces, so at most one card
+     * of source (the one whose face sits right below dest's top) can start the move.
+     * @return 0 if no run of source can be moved onto dest.
+     */
+    static std::size_t movableRunLength(const CardPile& source, const CardPile& dest) noexcept {
+        if (dest.empty()) {
+            return source.peekBase()->face() == Face::KING ? source.size() : 0;
+        }
+
+        int wantedFace = static_cast<int>(dest.peek()->face()) - 1;
+        int amount = wantedFace - static_cast<int>(source.peek()->face()) + 1;
+        if (amount < 1 || amount > static_cast<int>(source.size())) {
+            return 0;
+        }
+        if (canPlaceOnTableau(dest, *source.peek(amount - 1)) != PlacementResult::OK) {
+            return 0;
+        }
+        return amount;
+    }
+
+    void Game::generateMoves(MoveBuffer& buffer) const noexcept {
+        buffer.clear();
+        if (!this->heldCards.empty()) {
+            return;
+        }
+
+        if (!this->stock.empty()) {
+            std::size_t amount = std::min<std::size_t>(this->drawCount, this->stock.size());
+            buffer.push({MoveType::TURN_STOCK, 0, 0, static_cast<std::uint8_t>(amount)});
+        } else if (!this->waste.empty()) {
+            buffer.push({MoveType::RECYCLE_WASTE, 0, 0, static_cast<std::uint8_t>(this->waste.size())});
+        }
+
+        if (const Card *wasteTop = this->waste.peek()) {
+            auto suit = static_cast<std::uint8_t>(wasteTop->suit());
+            if (canPlaceOnFoundation(wasteTop->suit(), this->foundation[wasteTop->suit()], *wasteTop) == PlacementResult::OK) {
+                buffer.push({MoveType::WASTE_TO_FOUNDATION, 0, suit, 1});
+            }
+            for (std::uint8_t to = 0; to < NUM_TABLEAUS; to++) {
+                if (canPlaceOnTableau(this->openTableau[to], *wasteTop) == PlacementResult::OK) {
+                    buffer.push({MoveType::WASTE_TO_TABLEAU, 0, to, 1});
+                }
+            }
+        }
+
+        for (std::uint8_t from = 0; from < NUM_TABLEAUS; from++) {
+            const CardPile& source = this->openTableau[from];
+            if (source.empty()) {
+                if (!this->closedTableau[from].empty()) {
+                    buffer.push({MoveType::TURN_CLOSED_TABLEAU, from, 0, 1});
+                }
+                continue;
+            }
+
+            const Card *top = source.peek();
+            auto suit = static_cast<std::uint8_t>(top->suit());
+            if (canPlaceOnFoundation(top->suit(), this->foundation[top->suit()], *top) == PlacementResult::OK) {
+                buffer.push({MoveType::TABLEAU_TO_FOUNDATION, from, suit, 1});
+            }
+
+            for (std::uint8_t to = 0; to < NUM_TABLEAUS; to++) {
+                if (to == from) continue;
+                std::size_t amount = movableRunLength(source, this->openTableau[to]);
+                if (amount > 0) {
+                    buffer.push({MoveType::TABLEAU_TO_TABLEAU, from, to, static_cast<std::uint8_t>(amount)});
+                }
+            }
+        }
+
+        for (Suit s = Suit::FIRST; s < Suit::END; s++) {
+            const Card *top = this->foundation[s].peek();
+            if (top == nullptr) continue;
+            auto suit = static_cast<std::uint8_t>(s);
+            for (std::uint8_t to = 0; to < NUM_TABLEAUS; to++) {
+                if (canPlaceOnTableau(this->openTableau[to], *top) == PlacementResult::OK) {
+                    buffer.push({MoveType::FOUNDATION_TO_TABLEAU, suit, to, 1});
+                }
+            }
+        }
+    }
+
+    void Game::generateStockJumps(MoveBuffer& buffer) const noexcept {
+        if (!this->heldCards.empty() || this->stock.empty()) {
+            return;
+        }
+        std::size_t size = this->stock.size();
+        for (std::size_t depth = 0; depth + 1 < size; depth++) {
+            Card card = *this->stock.peek(depth);
+            if ((this->reachableThisPass >> card.index() & 1) && this->isPlayable(card)) {
+                buffer.push({MoveType::TURN_STOCK, 0, 0, static_cast<std::uint8_t>(depth + 1)});
+            }
+        }
+        buffer.push({MoveType::TURN_STOCK, 0, 0, static_cast<std::uint8_t>(size)});
+    }
+}
@@ -0,0 +1,217 @@
+#include "slt.hpp"
+
+#include <stdexcept>
+
+namespace solitaire {
+    namespace {
+        constexpr unsigned DRAW_BITS = 1;
+        constexpr unsigned MOVES_BITS = 24;
+        constexpr unsigned FOUNDATION_SIZE_BITS = 4;
+        constexpr unsigned STOCK_SIZE_BITS = 6;
+        constexpr unsigned CLOSED_SIZE_BITS = 3;
+        constexpr unsigned OPEN_SIZE_BITS = 4;
+        constexpr unsigned CARD_BITS = 6;
+
+        constexpr std::size_t SUIT_COUNT = static_cast<std::size_t>(Suit::COUNT);
+        constexpr std::size_t FACE_COUNT = static_cast<std::size_t>(Face::COUNT);
+        constexpr std::size_t SAVE_BITS = 8 + DRAW_BITS + MOVES_BITS
+            + SUIT_COUNT * FOUNDATION_SIZE_BITS
+            + 2 * STOCK_SIZE_BITS
+            + NUM_TABLEAUS * (CLOSED_SIZE_BITS + OPEN_SIZE_BITS)
+            + Card::DECK_SIZE * CARD_BITS;
+
+        static_assert((SAVE_BITS + 7) / 8 == Game::SAVE_SIZE, "Game::SAVE_SIZE must match the save layout");
+        static_assert(Card::DECK_SIZE <= (1u << CARD_BITS), "card indices must fit their field");
+        static_assert(FACE_COUNT < (1u << FOUNDATION_SIZE_BITS), "foundation sizes must fit their field");
+        static_assert(FACE_COUNT < (1u << OPEN_SIZE_BITS), "open tableau sizes must fit their field");
+        static_assert(NUM_TABLEAUS <= (1u << CLOSED_SIZE_BITS), "closed tableau sizes must fit their field");
+
+        // fields are at most 32 bits, so an accumulator of 64 always has room for the next one
+        class BitWriter {
+            std::uint8_t *out;
+            std::uint64_t pending = 0;
+            unsigned pendingBits = 0;
+
+        public:
+            explicit BitWriter(std::uint8_t *out): out(out) {}
+
+            void put(std::uint32_t value, unsigned bits) noexcept {
+                this->pending |= std::uint64_t(value) << this->pendingBits;
+                this->pendingBits += bits;
+                while (this->pendingBits >= 8) {
+                    *this->out++ = static_cast<std::uint8_t>(this->pending);
+                    this->pending >>= 8;
+                    this->pendingBits -= 8;
+                }
+            }
+
+            void flush() noexcept {
+                if (this->pendingBits > 0) {
+                    *this->out++ = static_cast<std::uint8_t>(this->pending);
+                    this->pending = 0;
+                    this->pendingBits = 0;
+                }
+            }
+        };
+
+        class BitReader {
+            const std::uint8_t *in;
+            const std::uint8_t *end;
+            std::uint64_t pending = 0;
+            unsigned pendingBits = 0;
+
+        public:
+            BitReader(const std::uint8_t *in, const std::uint8_t *end): in(in), end(end) {}
+
+            std::uint32_t get(unsigned bits) noexcept {
+                while (this->pendingBits < bits) {
+                    std::uint64_t byte = this->in < this->end ? *this->in++ : 0;
+                    this->pending |= byte << this->pendingBits;
+                    this->pendingBits += 8;
+                }
+                std::uint32_t value = static_cast<std::uint32_t>(this->pending & ((std::uint64_t(1) << bits) - 1));
+                this->pending >>= bits;
+                this->pendingBits -= bits;
+                return value;
+            }
+        };
+    }
+
+    void Game::save(SaveData& out) const {
+        if (!this->heldCards.empty()) {
+            throw std::logic_error("Cannot save a game while cards are being held.");
+        }
+        out.fill(0);
+        out[0] = SAVE_VERSION;
+        BitWriter writer(out.data() + 1);
+        writer.put(this->drawCount == 3 ? 1 : 0, DRAW_BITS);
+        writer.put(static_cast<std::uint32_t>(std::min(this->moves, (1 << MOVES_BITS) - 1)), MOVES_BITS);
+
+        for (const CardPile& pile : this->foundation) {
+            writer.put(static_cast<std::uint32_t>(pile.size()), FOUNDATION_SIZE_BITS);
+        }
+        writer.put(static_cast<std::uint32_t>(this->stock.size()), STOCK_SIZE_BITS);
+        writer.put(static_cast<std::uint32_t>(this->waste.size()), STOCK_SIZE_BITS);
+        for (const CardPile& pile : this->closedTableau) {
+            writer.put(static_cast<std::uint32_t>(pile.size()), CLOSED_SIZE_BITS);
+        }
+        for (const CardPile& pile : this->openTableau) {
+            writer.put(static_cast<std::uint32_t>(pile.size()), OPEN_SIZE_BITS);
+        }
+
+        auto putCards = [&writer](const CardPile& pile) {
+            for (auto card = pile.rbegin(); card != pile.rend(); card++) {
+                writer.put(static_cast<std::uint32_t>(card->index()), CARD_BITS);
+            }
+        };
+        putCards(this->stock);
+        putCards(this->waste);
+        for (const CardPile& pile : this->closedTableau) {
+            putCards(pile);
+        }
+        for (const CardPile& pile : this->openTableau) {
+            putCards(pile);
+        }
+        writer.flush();
+    }
+
+    bool Game::load(const SaveData& data) noexcept {
+        if (data[0] != SAVE_VERSION) {
+            return false;
+        }
+        BitReader reader(data.data() + 1, data.data() + data.size());
+        Game loaded;
+        loaded.stock = CardPile();
+        loaded.drawCount = reader.get(DRAW_BITS) ? 3 : 1;
+        loaded.moves = static_cast<int>(reader.get(MOVES_BITS));
+
+        std::uint64_t seen = 0; // by Card::index()
+        std::size_t cardCount = 0;
+        auto see = [&seen](Card card) {
+            std::uint64_t bit = std::uint64_t(1) << card.index();
+            bool fresh = (seen & bit) == 0;
+            seen |= bit;
+            return fresh;
+        };
+
+        for (Suit s = Suit::FIRST; s < Suit::END; s++) {
+            std::size_t size = reader.get(FOUNDATION_SIZE_BITS);
+            if (size > FACE_COUNT) {
+                return false;
+            }
+            for (std::size_t i = 0; i < size; i++) {
+                Card card = Card::fromIndex(static_cast<std::size_t>(s) * FACE_COUNT + i);
+                see(card);
+                loaded.foundation[s].add(card);
+            }
+            cardCount += size;
+        }
+
+        std::size_t stockSize = reader.get(STOCK_SIZE_BITS);
+        std::size_t wasteSize = reader.get(STOCK_SIZE_BITS);
+        std::array<std::size_t, NUM_TABLEAUS> closedSizes;
+        std::array<std::size_t, NUM_TABLEAUS> openSizes;
+        for (std::size_t& size : closedSizes) {
+            size = reader.get(CLOSED_SIZE_BITS);
+        }
+        for (std::size_t& size : openSizes) {
+            size = reader.get(OPEN_SIZE_BITS);
+        }
+        cardCount += stockSize + wasteSize;
+        for (std::size_t i = 0; i < NUM_TABLEAUS; i++) {
+            cardCount += closedSizes[i] + openSizes[i];
+        }
+        if (cardCount != Card::DECK_SIZE) {
+            return false;
+        }
+
+        auto getCards = [&](CardPile& pile, std::size_t size) {
+            for (std::size_t i = 0; i < size; i++) {
+                std::size_t index = reader.get(CARD_BITS);
+                if (index >= Card::DECK_SIZE || !see(Card::fromIndex(index))) {
+                    return false;
+                }
+                pile.add(Card::fromIndex(index));
+            }
+            return true;
+        };
+        if (!getCards(loaded.stock, stockSize) || !getCards(loaded.waste, wasteSize)) {
+            return false;
+        }
+        for (std::size_t i = 0; i < NUM_TABLEAUS; i++) {
+            if (!getCards(loaded.closedTableau[i], closedSizes[i])) {
+                return false;
+            }
+        }
+        for (std::size_t i = 0; i < NUM_TABLEAUS; i++) {
+            CardPile& pile = loaded.openTableau[i];
+            for (std::size_t j = 0; j < openSizes[i]; j++) {
+                std::size_t index = reader.get(CARD_BITS);
+                if (index >= Card::DECK_SIZE || !see(Card::fromIndex(index))) {
+                    return false;
+                }
+                // the base may be any card, but the rest must follow the tableau rules
+                Card card = Card::fromIndex(index);
+                if (!pile.empty() && canPlaceOnTableau(pile, card) != PlacementResult::OK) {
+                    return false;
+                }
+                pile.add(card);
+            }
+        }
+
+        loaded.hash = loaded.computeHash();
+        loaded.computeReachableThisPass();
+        loaded.computeReachableLaterPasses();
+        *this = loaded;
+        return true;
+    }
+
+    Game *Game::createFromSave(const SaveData& data) {
+        Game *g = new Game();
+        if (!g->load(data)) {
+            delete g;
+            throw InvalidSaveException("The saved game is corrupt or of another version");
+        }
+        return g;
+    }
+}
@@ -1,9 +1,12 @@
 #include "slt.hpp"
 #include "except.hpp"
 #include "options.hpp"
+#include "zobrist.hpp"
 
 #include <sstream>
-    #include <iostream>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
 
 namespace solitaire {
     bool suitsCanAlternate(Suit s1, Suit s2) noexcept {
@@ -17,67 +20,90 @@ namespace solitaire {
         return f + s != 3 && f != s;
     }
 
-    bool Game::canStack(const CardPile& bottom, const CardPile& top) {
-        if (bottom.empty()) {
-            return top.peekBase()->face == Face::KING;
+    const char *placementResultToString(PlacementResult r) noexcept {
+        switch (r) {
+            case PlacementResult::OK: return "ok";
+            case PlacementResult::NO_SUCH_PILE: return "no such pile";
+            case PlacementResult::NO_CARDS: return "no cards to place";
+            case PlacementResult::TOO_MANY_CARDS: return "too many cards to place";
+            case PlacementResult::MISMATCHED_SUITS: return "mismatched suits";
+            case PlacementResult::NON_SEQUENTIAL_FACES: return "non-sequential faces";
+            case PlacementResult::NOT_A_KING: return "only a king can start an empty tableau";
+            case PlacementResult::NOT_AN_ACE: return "only an ace can start an empty foundation";
         }
+        return "unknown placement result";
+    }
 
-        const Card *bottomContact = bottom.peek();
-        const Card *topContact = top.peekBase();
-        Face tcFace = topContact->face;
-        ++tcFace;
-
-        return suitsCanAlternate(bottomContact->suit, topContact->suit) && tcFace == bottomContact->face;
+    void throwIfFailed(PlacementResult r) {
+        switch (r) {
+            case PlacementResult::OK:
+                return;
+            case PlacementResult::NO_SUCH_PILE:
+                throw std::out_of_range(placementResultToString(r));
+            case PlacementResult::NO_CARDS:
+                throw NotEnoughCardsException();
+            case PlacementResult::TOO_MANY_CARDS:
+                throw TooManyCardsException();
+            case PlacementResult::MISMATCHED_SUITS:
+                throw MismatchedSuitsException();
+            case PlacementResult::NON_SEQUENTIAL_FACES:
+                throw NonSequentialFacesException();
+            case PlacementResult::NOT_A_KING:
+            case PlacementResult::NOT_AN_ACE:
+                throw InvalidCardPlacementException();
+        }
     }
 
-    void throwIfCantStackInTableau(const CardPile& pile, const Card& newCard) {
+    PlacementResult canPlaceOnTableau(const CardPile& pile, Card newCard) noexcept {
         if (pile.empty()) {
-            if (newCard.face == Face::KING) {
-                return;
+            if (newCard.face() == Face::KING) {
+                return PlacementResult::OK;
             } else {
-                throw InvalidCardPlacementException();
+                return PlacementResult::NOT_A_KING;
             }
         }
         const Card *oldTop = pile.peek();
-        if (!suitsCanAlternate(oldTop->suit, newCard.suit)) {
-            throw MismatchedSuitsException();
+        if (!suitsCanAlternate(oldTop->suit(), newCard.suit())) {
+            return PlacementResult::MISMATCHED_SUITS;
         }
-        Face newCardFace = newCard.face;
+        Face newCardFace = newCard.face();
 
         // I'm too lazy to implement operator+.
-        if (oldTop->face != (++newCardFace)) {
-            throw NonSequentialFacesException();
+        if (oldTop->face() != (++newCardFace)) {
+            return PlacementResult::NON_SEQUENTIAL_FACES;
         }
+        return PlacementResult::OK;
     }
 
-    void throwIfCantStackInFoundation(Suit foundationSuit, const CardPile& pile, const Card& newCard) {
-        if (newCard.suit != foundationSuit) {
-            throw MismatchedSuitsException();
+    PlacementResult canPlaceOnFoundation(Suit foundationSuit, const CardPile& pile, Card newCard) noexcept {
+        if (newCard.suit() != foundationSuit) {
+            return PlacementResult::MISMATCHED_SUITS;
         }
         if (pile.empty()) {
-            if (newCard.face == Face::ACE) {
-                return; // ok
+            if (newCard.face() == Face::ACE) {
+                return PlacementResult::OK;
             } else {
-                throw InvalidCardPlacementException();
+                return PlacementResult::NOT_AN_ACE;
             }
         }
-        Face oldTopFace = pile.peek()->face;
+        Face oldTopFace = pile.peek()->face();
 
         // I'm too lazy to implement operator+.
-        if ((++oldTopFace) != newCard.face) {
-            throw NonSequentialFacesException();
+        if ((++oldTopFace) != newCard.face()) {
+            return PlacementResult::NON_SEQUENTIAL_FACES;
         }
+        return PlacementResult::OK;
     }
 
+    static_assert(std::is_trivially_copyable_v<Game>, "Game must stay cheap to snapshot");
+
     Game::Game() {
         this->initFullDeckInOrder();
     }
 
-    Game::~Game() {
-        for (Card *c : this->allCards) {
-            delete c;
-        }
-        this->allCards.clear();
+    Game *Game::createFromSeed(std::minstd_rand::result_type seed, config::wasteDifficulty difficulty) {
+        std::minstd_rand rand(seed);
+        return Game::createAndDealGame(rand, difficulty);
     }
 
     void Game::dealGame() {
@@ -85,37 +111,58 @@ namespace solitaire {
         this->initFoundations();
         this->dealClosedTableau();
         this->dealOpenTableau();
+        this->hash = this->computeHash();
+        this->computeReachableThisPass();
+        this->computeReachableLaterPasses();
     }
 
     bool Game::hasStock() const noexcept {
         return !this->stock.empty();
     }
 
-    void Game::turnStock() {
+    MoveRecord Game::turnStock() {
         if (this->stock.empty()) {
             throw NotEnoughCardsException();
         }
-        auto card = this->stock.takeTop();
-        this->waste.add(card);
-        this->moves++;
+        std::size_t amount = std::min<std::size_t>(this->drawCount, this->stock.size());
+        return this->apply({MoveType::TURN_STOCK, 0, 0, static_cast<std::uint8_t>(amount)});
+    }
+
+    std::size_t Game::getDrawCount() const noexcept {
+        return this->drawCount;
     }
 
-    void Game::turnClosedTableauTop(std::size_t index) {
+    MoveRecord Game::turnClosedTableauTop(std::size_t index) {
         if (!this->openTableau.at(index).empty()) {
             throw std::logic_error("Cannot flip closed tableau while there are cards above it in the open tableau.");
         }
         if (this->closedTableau.at(index).empty()) {
             throw NotEnoughCardsException();
         }
-        auto card = this->closedTableau.at(index).takeTop();
-        this->openTableau.at(index).add(card);
+        return this->apply({MoveType::TURN_CLOSED_TABLEAU, static_cast<std::uint8_t>(index), 0, 1});
     }
 
-    void Game::returnWasteToStock() {
+    MoveRecord Game::returnWasteToStock() {
         if (this->hasStock()) {
             throw std::logic_error("Cannot turn waste onto stock if stock is not empty.");
         }
-        this->waste.turnOnto(this->stock);
+        return this->apply({MoveType::RECYCLE_WASTE, 0, 0, static_cast<std::uint8_t>(this->waste.size())});
+    }
+
+    const CardPile& Game::getStock() const noexcept {
+        return this->stock;
+    }
+
+    const CardPile& Game::getWaste() const noexcept {
+        return this->waste;
+    }
+
+    std::uint64_t Game::getReachableThisPass() const noexcept {
+        return this->reachableThisPass;
+    }
+
+    std::uint64_t Game::getReachableLaterPasses() const noexcept {
+        return this->reachableLaterPasses;
     }
 
     const Card *Game::peekWaste() const noexcept {
@@ -123,7 +170,7 @@ namespace solitaire {
     }
 
     const Card *Game::peekFoundation(Suit s) const {
-        return this->foundation.at(s).peek();
+        return this->foundationPile(s).peek();
     }
 
     void Game::returnHeldCards() {
@@ -138,7 +185,7 @@ namespace solitaire {
                 break;
             case PossibleHeldCardsSource::FOUNDATION:
                 s = this->heldSourcePileExtra.foundationSuit;
-                this->foundation.at(s).stack(this->heldCards);
+                this->foundationPile(s).stack(this->heldCards);
                 break;
             case PossibleHeldCardsSource::TABLEAU:
                 index = this->heldSourcePileExtra.tableauIndex;
@@ -147,7 +194,7 @@ namespace solitaire {
         }
     }
 
-    const CardPile& Game::getHeldCards() {
+    const CardPile& Game::getHeldCards() const noexcept {
         return this->heldCards;
     }
 
@@ -157,7 +204,7 @@ namespace solitaire {
         }
     }
 
-    void Game::throwIfAttemptingToGrabEmptyPile(CardPile pile) {
+    void Game::throwIfAttemptingToGrabEmptyPile(const CardPile& pile) {
         if (this->heldCards.empty() && pile.empty()) {
             throw std::logic_error("Cannot grab an empty pile.");
         }
@@ -165,34 +212,28 @@ namespace solitaire {
 
     void Game::takeWaste() {
         this->throwIfAttemptingToHoldMoreCards();
-        CardPile *topCard = this->waste.split(1);
-        this->heldCards.stack(*topCard);
+        this->waste.moveTopOnto(this->heldCards, 1);
         this->heldCardsSource = PossibleHeldCardsSource::WASTE;
-        delete topCard;
     }
 
-    bool Game::hasWaste() {
+    bool Game::hasWaste() const noexcept {
         return !this->waste.empty();
     }
 
     void Game::takeFoundation(Suit s) {
         this->throwIfAttemptingToHoldMoreCards();
-        this->throwIfAttemptingToGrabEmptyPile(this->foundation.at(s));
+        this->throwIfAttemptingToGrabEmptyPile(this->foundationPile(s));
 
-        CardPile *topCard = this->foundation.at(s).split(1);
-        this->heldCards.stack(*topCard);
+        this->foundationPile(s).moveTopOnto(this->heldCards, 1);
         this->heldCardsSource = PossibleHeldCardsSource::FOUNDATION;
         this->heldSourcePileExtra.foundationSuit = s;
-        delete topCard;
     }
 
     void Game::takeTableau(std::size_t index, std::size_t amount) {
         this->throwIfAttemptingToHoldMoreCards();
-        CardPile *split = this->openTableau.at(index).split(amount);
-        this->heldCards.stack(*split);
+        this->openTableau.at(index).moveTopOnto(this->heldCards, amount);
         this->heldCardsSource = PossibleHeldCardsSource::TABLEAU;
         this->heldSourcePileExtra.tableauIndex = index;
-        delete split;
     }
 
     const CardPile& Game::getOpenTableau(std::size_t index) const {
@@ -203,55 +244,360 @@ namespace solitaire {
         return this->closedTableau.at(index).size();
     }
 
-    void Game::stackTableau(std::size_t index) {
+    PlacementResult Game::canPlaceHeldOnTableau(std::size_t index) const noexcept {
+        if (index >= this->openTableau.size()) {
+            return PlacementResult::NO_SUCH_PILE;
+        }
         if (this->heldCards.empty()) {
-            throw NotEnoughCardsException();
+            return PlacementResult::NO_CARDS;
+        }
+        return canPlaceOnTableau(this->openTableau[index], *this->heldCards.peekBase());
+    }
+
+    PlacementResult Game::canPlaceHeldOnFoundation(Suit suit) const noexcept {
+        if (suit < Suit::FIRST || suit >= Suit::END) {
+            return PlacementResult::NO_SUCH_PILE;
+        }
+        if (this->heldCards.empty()) {
+            return PlacementResult::NO_CARDS;
+        } else if (this->heldCards.size() > 1) {
+            return PlacementResult::TOO_MANY_CARDS;
+        }
+        return canPlaceOnFoundation(suit, this->foundation[suit], *this->heldCards.peek());
+    }
+
+    PlacementResult Game::tryStackTableau(std::size_t index, MoveRecord *record) noexcept {
+        PlacementResult result = this->canPlaceHeldOnTableau(index);
+        if (result != PlacementResult::OK) {
+            return result;
+        }
+
+        bool fromTableau = this->heldCardsSource == PossibleHeldCardsSource::TABLEAU;
+        std::size_t heldIndex = this->heldSourcePileExtra.tableauIndex;
+        if (fromTableau && index == heldIndex) {
+            // dropped back where it came from, which is not a move
+            this->openTableau[index].stack(this->heldCards);
+            return PlacementResult::OK;
         }
 
-        throwIfCantStackInTableau(this->openTableau.at(index), *this->heldCards.peekBase());
-        if (index != this->heldSourcePileExtra.tableauIndex) {
-            this->moves++;
+        MoveRecord played {
+            {MoveType::TABLEAU_TO_TABLEAU, 0, static_cast<std::uint8_t>(index), static_cast<std::uint8_t>(this->heldCards.size())},
+            false
+        };
+        switch (this->heldCardsSource) {
+            case PossibleHeldCardsSource::WASTE:
+                played.move.type = MoveType::WASTE_TO_TABLEAU;
+                break;
+            case PossibleHeldCardsSource::FOUNDATION:
+                played.move.type = MoveType::FOUNDATION_TO_TABLEAU;
+                played.move.from = static_cast<std::uint8_t>(this->heldSourcePileExtra.foundationSuit);
+                break;
+            case PossibleHeldCardsSource::TABLEAU:
+                played.move.from = static_cast<std::uint8_t>(heldIndex);
+                break;
+        }
+
+        this->moves++;
+        this->hashHeldCardsLanding(zobrist::FIRST_OPEN_TABLEAU + index);
+        this->openTableau[index].stack(this->heldCards);
+        if (fromTableau) {
+            played.flippedClosedCard = this->autoTurnClosedTableauTop(heldIndex);
+        } else if (played.move.type == MoveType::WASTE_TO_TABLEAU) {
+            this->computeReachableLaterPasses();
+        }
+        if (record != nullptr) {
+            *record = played;
+        }
+        return PlacementResult::OK;
+    }
+
+    MoveRecord Game::stackTableau(std::size_t index) {
+        MoveRecord record {};
+        throwIfFailed(this->tryStackTableau(index, &record));
+        return record;
+    }
+
+    PlacementResult Game::tryStackFoundation(Suit suit, MoveRecord *record) noexcept {
+        PlacementResult result = this->canPlaceHeldOnFoundation(suit);
+        if (result != PlacementResult::OK) {
+            return result;
         }
 
-        int heldIndex = this->heldSourcePileExtra.tableauIndex;
-        this->openTableau.at(index).stack(this->heldCards);
+        auto suitIndex = static_cast<std::uint8_t>(suit);
+        if (this->heldCardsSource == PossibleHeldCardsSource::FOUNDATION) {
+            // a foundation only accepts its own suit, so this card went back where it came from
+            this->foundation[suit].stack(this->heldCards);
+            return PlacementResult::OK;
+        }
+        this->hashHeldCardsLanding(zobrist::FIRST_FOUNDATION + suitIndex);
+        this->foundation[suit].stack(this->heldCards);
+
+        MoveRecord played {{MoveType::WASTE_TO_FOUNDATION, 0, suitIndex, 1}, false};
+        if (this->heldCardsSource == PossibleHeldCardsSource::TABLEAU) {
+            std::size_t heldIndex = this->heldSourcePileExtra.tableauIndex;
+            played.move.type = MoveType::TABLEAU_TO_FOUNDATION;
+            played.move.from = static_cast<std::uint8_t>(heldIndex);
+            played.flippedClosedCard = this->autoTurnClosedTableauTop(heldIndex);
+        } else {
+            this->computeReachableLaterPasses();
+        }
+
+        this->moves++;
+        if (record != nullptr) {
+            *record = played;
+        }
+        return PlacementResult::OK;
+    }
+
+    MoveRecord Game::stackFoundation(Suit suit) {
+        MoveRecord record {};
+        throwIfFailed(this->tryStackFoundation(suit, &record));
+        return record;
+    }
+
+    bool Game::autoTurnClosedTableauTop(std::size_t index) noexcept {
         if (config::autoplayClosedTableauTop
-            && this->getClosedTableauSize(heldIndex) > 0
-            && this->getOpenTableau(heldIndex).size() == 0
-            && this->heldCardsSource == PossibleHeldCardsSource::TABLEAU
+            && !this->closedTableau[index].empty()
+            && this->openTableau[index].empty()
         ) {
-            this->turnClosedTableauTop(heldIndex);
+            this->moveCards(zobrist::FIRST_CLOSED_TABLEAU + index, zobrist::FIRST_OPEN_TABLEAU + index, 1);
+            return true;
         }
+        return false;
+    }
+
+    MoveRecord Game::apply(const Move& move) noexcept {
+        using namespace zobrist;
+        MoveRecord record {move, false};
+        switch (move.type) {
+            case MoveType::TURN_STOCK:
+                this->turnCards(STOCK, WASTE, move.count);
+                this->moves += this->stockTurnMoves(move.count);
+                if (move.count % this->drawCount == 0 || this->stock.empty()) {
+                    // whole turns keep every card left in the stock as far from a turn's end as before
+                    for (std::size_t i = 0; i < move.count; i++) {
+                        this->reachableThisPass &= ~(std::uint64_t(1) << this->waste.peek(i)->index());
+                    }
+                } else {
+                    this->computeReachableThisPass();
+                }
+                break;
+            case MoveType::RECYCLE_WASTE:
+                this->turnCards(WASTE, STOCK, move.count);
+                // the next pass turns the cards in the same order as every later one
+                this->reachableThisPass = this->reachableLaterPasses;
+                break;
+            case MoveType::WASTE_TO_TABLEAU:
+                this->moveCards(WASTE, FIRST_OPEN_TABLEAU + move.to, move.count);
+                this->computeReachableLaterPasses();
+                this->moves++;
+                break;
+            case MoveType::WASTE_TO_FOUNDATION:
+                this->moveCards(WASTE, FIRST_FOUNDATION + move.to, move.count);
+                this->computeReachableLaterPasses();
+                this->moves++;
+                break;
+            case MoveType::TABLEAU_TO_TABLEAU:
+                this->moveCards(FIRST_OPEN_TABLEAU + move.from, FIRST_OPEN_TABLEAU + move.to, move.count);
+                record.flippedClosedCard = this->autoTurnClosedTableauTop(move.from);
+                this->moves++;
+                break;
+            case MoveType::TABLEAU_TO_FOUNDATION:
+                this->moveCards(FIRST_OPEN_TABLEAU + move.from, FIRST_FOUNDATION + move.to, move.count);
+                record.flippedClosedCard = this->autoTurnClosedTableauTop(move.from);
+                this->moves++;
+                break;
+            case MoveType::FOUNDATION_TO_TABLEAU:
+                this->moveCards(FIRST_FOUNDATION + move.from, FIRST_OPEN_TABLEAU + move.to, move.count);
+                this->moves++;
+                break;
+            case MoveType::TURN_CLOSED_TABLEAU:
+                this->moveCards(FIRST_CLOSED_TABLEAU + move.from, FIRST_OPEN_TABLEAU + move.from, move.count);
+                break;
+        }
+        return record;
     }
 
-    void Game::stackFoundation(Suit suit) {
-        if (this->heldCards.empty()) {
-            throw NotEnoughCardsException();
-        } else if (this->heldCards.size() > 1) {
-            throw TooManyCardsException();
+    void Game::revert(const MoveRecord& record) noexcept {
+        using namespace zobrist;
+        const Move& move = record.move;
+        if (record.flippedClosedCard) {
+            this->moveCards(FIRST_OPEN_TABLEAU + move.from, FIRST_CLOSED_TABLEAU + move.from, 1);
         }
-        const Card *single = this->heldCards.peek();
+        switch (move.type) {
+            case MoveType::TURN_STOCK:
+                this->turnCards(WASTE, STOCK, move.count);
+                this->computeReachableThisPass();
+                this->moves -= this->stockTurnMoves(move.count);
+                break;
+            case MoveType::RECYCLE_WASTE:
+                this->turnCards(STOCK, WASTE, move.count);
+                this->reachableThisPass = 0;
+                break;
+            case MoveType::WASTE_TO_TABLEAU:
+                this->moveCards(FIRST_OPEN_TABLEAU + move.to, WASTE, move.count);
+                this->computeReachableLaterPasses();
+                this->moves--;
+                break;
+            case MoveType::WASTE_TO_FOUNDATION:
+                this->moveCards(FIRST_FOUNDATION + move.to, WASTE, move.count);
+                this->computeReachableLaterPasses();
+                this->moves--;
+                break;
+            case MoveType::TABLEAU_TO_TABLEAU:
+                this->moveCards(FIRST_OPEN_TABLEAU + move.to, FIRST_OPEN_TABLEAU + move.from, move.count);
+                this->moves--;
+                break;
+            case MoveType::TABLEAU_TO_FOUNDATION:
+                this->moveCards(FIRST_FOUNDATION + move.to, FIRST_OPEN_TABLEAU + move.from, move.count);
+                this->moves--;
+                break;
+            case MoveType::FOUNDATION_TO_TABLEAU:
+                this->moveCards(FIRST_OPEN_TABLEAU + move.to, FIRST_FOUNDATION + move.from, move.count);
+                this->moves--;
+                break;
+            case MoveType::TURN_CLOSED_TABLEAU:
+                this->moveCards(FIRST_OPEN_TABLEAU + move.from, FIRST_CLOSED_TABLEAU + move.from, move.count);
+                break;
+        }
+    }
 
-        throwIfCantStackInFoundation(suit, this->foundation.at(suit), *single);
+    int Game::stockTurnMoves(std::size_t amount) const noexcept {
+        // one move per turn of the stock, even when several turns are played at once
+        return static_cast<int>((amount + this->drawCount - 1) / this->drawCount);
+    }
 
-        int heldIndex = this->heldSourcePileExtra.tableauIndex;
-        this->foundation.at(suit).stack(this->heldCards);
-        if (
-            config::autoplayClosedTableauTop
-            && this->heldCardsSource == PossibleHeldCardsSource::TABLEAU
-            && this->getClosedTableauSize(heldIndex) > 0
-            && this->getOpenTableau(heldIndex).size() == 0
-        ) {
-            this->turnClosedTableauTop(heldIndex);
+    bool Game::isPlayable(Card card) const noexcept {
+        if (canPlaceOnFoundation(card.suit(), this->foundation[card.suit()], card) == PlacementResult::OK) {
+            return true;
         }
+        for (const CardPile& tableau : this->openTableau) {
+            if (canPlaceOnTableau(tableau, card) == PlacementResult::OK) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Game::computeReachableThisPass() noexcept {
+        // a turn ends on every drawCount-th card from the top, and the last turn on the bottom card
+        std::uint64_t reachable = 0;
+        std::size_t size = this->stock.size();
+        for (std::size_t depth = 0; depth < size; depth++) {
+            if ((depth + 1) % this->drawCount == 0 || depth + 1 == size) {
+                reachable |= std::uint64_t(1) << this->stock.peek(depth)->index();
+            }
+        }
+        this->reachableThisPass = reachable;
+    }
+
+    void Game::computeReachableLaterPasses() noexcept {
+        // after recycling, the waste comes back off the stock from its base up, then the current stock
+        std::uint64_t reachable = 0;
+        std::size_t size = this->waste.size() + this->stock.size();
+        std::size_t position = 0;
+        auto visit = [&](Card card) {
+            position++;
+            if (position % this->drawCount == 0 || position == size) {
+                reachable |= std::uint64_t(1) << card.index();
+            }
+        };
+        for (auto card = this->waste.rbegin(); card != this->waste.rend(); card++) {
+            visit(*card);
+        }
+        for (Card card : this->stock) {
+            visit(card);
+        }
+        this->reachableLaterPasses = reachable;
+    }
+
+    std::uint64_t Game::getHash() const noexcept {
+        return this->hash;
+    }
 
-        if (this->heldCardsSource != PossibleHeldCardsSource::FOUNDATION) {
-            this->moves++;
+    std::uint64_t Game::computeHash() const noexcept {
+        std::uint64_t h = 0;
+        for (std::size_t pile = 0; pile < zobrist::PILE_COUNT; pile++) {
+            std::size_t depth = 0;
+            for (auto card = this->pileAt(pile).rbegin(); card != this->pileAt(pile).rend(); card++) {
+                h ^= zobrist::key(pile, depth++, *card);
+            }
         }
+        return h;
+    }
+
+    CardPile& Game::pileAt(std::size_t pile) noexcept {
+        return const_cast<CardPile&>(static_cast<const Game *>(this)->pileAt(pile));
     }
 
-    bool Game::hasFoundation(Suit suit) {
-        return !this->foundation.at(suit).empty();
+    const CardPile& Game::pileAt(std::size_t pile) const noexcept {
+        using namespace zobrist;
+        if (pile == STOCK) return this->stock;
+        if (pile == WASTE) return this->waste;
+        if (pile < FIRST_OPEN_TABLEAU) return this->foundation[static_cast<Suit>(pile - FIRST_FOUNDATION)];
+        if (pile < FIRST_CLOSED_TABLEAU) return this->openTableau[pile - FIRST_OPEN_TABLEAU];
+        return this->closedTableau[pile - FIRST_CLOSED_TABLEAU];
+    }
+
+    std::size_t Game::heldSourcePile() const noexcept {
+        switch (this->heldCardsSource) {
+            case PossibleHeldCardsSource::WASTE:
+                return zobrist::WASTE;
+            case PossibleHeldCardsSource::FOUNDATION:
+                return zobrist::FIRST_FOUNDATION + static_cast<std::size_t>(this->heldSourcePileExtra.foundationSuit);
+            case PossibleHeldCardsSource::TABLEAU:
+                break;
+        }
+        return zobrist::FIRST_OPEN_TABLEAU + this->heldSourcePileExtra.tableauIndex;
+    }
+
+    void Game::hashHeldCardsLanding(std::size_t to) noexcept {
+        // held cards still count as lying on top of the pile they came from
+        std::size_t from = this->heldSourcePile();
+        std::size_t fromDepth = this->pileAt(from).size();
+        std::size_t toDepth = this->pileAt(to).size();
+        std::size_t amount = this->heldCards.size();
+        for (std::size_t i = 0; i < amount; i++) {
+            Card card = *this->heldCards.peek(amount - 1 - i);
+            this->hash ^= zobrist::key(from, fromDepth + i, card) ^ zobrist::key(to, toDepth + i, card);
+        }
+    }
+
+    void Game::moveCards(std::size_t from, std::size_t to, std::size_t amount) noexcept {
+        CardPile& source = this->pileAt(from);
+        CardPile& dest = this->pileAt(to);
+        std::size_t fromDepth = source.size() - amount;
+        std::size_t toDepth = dest.size();
+        for (std::size_t i = 0; i < amount; i++) {
+            Card card = *source.peek(amount - 1 - i);
+            this->hash ^= zobrist::key(from, fromDepth + i, card) ^ zobrist::key(to, toDepth + i, card);
+        }
+        source.moveTopOnto(dest, amount);
+    }
+
+    void Game::turnCards(std::size_t from, std::size_t to, std::size_t amount) noexcept {
+        CardPile& source = this->pileAt(from);
+        CardPile& dest = this->pileAt(to);
+        std::size_t fromSize = source.size();
+        std::size_t toDepth = dest.size();
+        for (std::size_t i = 0; i < amount; i++) {
+            // the i-th card from the top lands i cards above dest's old top
+            Card card = *source.peek(i);
+            this->hash ^= zobrist::key(from, fromSize - 1 - i, card) ^ zobrist::key(to, toDepth + i, card);
+        }
+        source.turnTopOnto(dest, amount);
+    }
+
+    bool Game::hasFoundation(Suit suit) const {
+        return !this->foundationPile(suit).empty();
+    }
+
+    CardPile& Game::foundationPile(Suit s) {
+        return this->foundation.at(s);
+    }
+
+    const CardPile& Game::foundationPile(Suit s) const {
+        return this->foundation.at(s);
     }
 
     void Game::deal(CardPile& onto) {
@@ -259,70 +605,51 @@ namespace solitaire {
         onto.add(newCard);
     }
 
-    int Game::getMoveCount() { return moves; }
+    int Game::getMoveCount() const noexcept { return moves; }
 
-    void Game::attemptHeldToFoundation() {
-        if (this->heldCards.size() != 1) return;
-
-        Card heldCard = *this->heldCards.peek();
-        Face heldFace = this->heldCards.peekBase()->face;
-        for (Suit s = Suit::FIRST; s < Suit::END; s++) {
-            if (heldCard.suit == s && heldCard.face == Face::ACE) {
-                this->stackFoundation(s);
-                return;
-            }
-            if (!this->hasFoundation(s)) continue; // prevent checking a foundation that doesn't exist.
-
-            Face topFace = this->foundation.at(s).peek()->face;
-            if (
-                this->heldCards.peekBase()->suit == s
-                && (++topFace) == heldFace
-            ) {
-                this->stackFoundation(s);
-                return;
+    bool Game::isWon() const noexcept {
+        for (const CardPile& pile : this->foundation) {
+            if (pile.size() != static_cast<std::size_t>(Face::COUNT)) {
+                return false;
             }
         }
-
+        return true;
     }
 
-    void Game::attemptHeldToTableau() {
-        Face heldContact = this->heldCards.peekBase()->face;
+    MoveRecord Game::attemptHeldToFoundation() {
+        MoveRecord record {};
+        if (this->heldCards.size() != 1) return record;
 
-        std::vector<std::size_t> valid;
+        this->tryStackFoundation(this->heldCards.peek()->suit(), &record);
+        return record;
+    }
 
+    MoveRecord Game::attemptHeldToTableau() {
+        MoveRecord record {};
         for (std::size_t i = 0; i < NUM_TABLEAUS; i++) {
             if (this->heldCardsSource == PossibleHeldCardsSource::TABLEAU
                 && this->heldSourcePileExtra.tableauIndex == i
             ) continue;
 
-            if (heldContact == Face::KING && this->getOpenTableau(i).empty()) {
-                this->stackTableau(i);
-                return;
-            }
-
-            if (!this->getOpenTableau(i).empty() && this->canStack(this->getOpenTableau(i), this->heldCards)) {
-                valid.emplace_back(i);
+            if (this->canPlaceHeldOnTableau(i) == PlacementResult::OK) {
+                this->tryStackTableau(i, &record);
+                break;
             }
         }
-
-        if (!valid.empty()) {
-            this->stackTableau(valid[0]);
-        }
+        return record;
     }
 
     void Game::initFullDeckInOrder() noexcept {
         for (Suit s = Suit::FIRST; s < Suit::END; s++) {
             for (Face f = Face::FIRST; f < Face::END; f++) {
-                Card *c = new Card(f, s);
-                this->allCards.push_back(c);
-                this->stock.add(c);
+                this->stock.add(Card(f, s));
             }
         }
     }
 
     void Game::initFoundations() noexcept {
-        for (Suit s = Suit::FIRST; s < Suit::END; s++) {
-            this->foundation.emplace(s, CardPile());
+        for (CardPile& pile : this->foundation) {
+            pile = CardPile();
         }
     }
 
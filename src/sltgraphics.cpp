@@ -1,50 +1,244 @@
 #include "sltgraphics.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <thread>
 #include <utility>
+#include <vector>
 #include <raymath.h>
+#include <rlgl.h>
 #include <iostream>
-#include <sstream>
 
+#include "assetpack.hpp"
 #include "utils.hpp"
 #include "options.hpp"
 
 namespace solitaire {
     GraphicalGame::GraphicalGame() {
-        std::string basePath(CARD_TEXTURE_PATH_PREFIX);
-        for (Suit s = Suit::FIRST; s < Suit::END; s++) {
-            std::stringstream suitPath;
-            suitPath << basePath;
-            suitPath << suitToChar(s);
-            for (Face f = Face::FIRST; f < Face::END; f++) {
-                std::stringstream cardPath;
-                cardPath << suitPath.str();
-                cardPath << '/' << faceToChar(f) << ".png";
-
-                Texture tex = LoadTexture(cardPath.str().c_str());
-                this->cardTextures.emplace(std::make_pair(s, f), tex);
-            }
-        }
-        auto backTexturePath = basePath + CARD_BACK_TEXTURE_PATH_SUFFIX;
-        this->cardBackTexture = LoadTexture(backTexturePath.c_str());
+        this->loadCardAtlas();
 
         // TODO calculate resolution
         this->actualResolution = TARGET_RESOLUTION;
 
         this->calculateBounds();
+        this->boardLayer = LoadRenderTexture(
+            static_cast<int>(this->actualResolution.x),
+            static_cast<int>(this->actualResolution.y)
+        );
+    }
+
+    GraphicalGame::GraphicalGame(Vector2 cardSize) {
+        // only what the input handlers look at: the layout, which follows from the card size
+        this->headless = true;
+        this->cardBackAtlasRegion = {0, 0, cardSize.x, cardSize.y};
+        this->actualResolution = TARGET_RESOLUTION;
+        this->calculateBounds();
     }
 
     GraphicalGame::~GraphicalGame() {
-        for (auto entry : this->cardTextures) {
-            Texture tex = entry.second;
-            UnloadTexture(tex);
+        if (!this->headless) {
+            UnloadTexture(this->cardAtlas);
+            UnloadRenderTexture(this->boardLayer);
         }
-        UnloadTexture(this->cardBackTexture);
         delete this->game;
     }
 
+    static std::string cardImageName(Card card) {
+        std::string name(1, suitToChar(card.suit()));
+        name += '/';
+        name += faceToChar(card.face());
+        return name;
+    }
+
+    void GraphicalGame::loadCardAtlas() {
+        auto started = std::chrono::steady_clock::now();
+        const char *source = ASSET_PACK_PATH;
+        try {
+            this->loadCardAtlasFromPack(ASSET_PACK_PATH);
+        } catch (const std::exception& e) {
+            std::cerr << "Could not load the asset pack: " << e.what() << std::endl;
+            std::cerr << "Decoding the card images instead; run `make assets` to start faster." << std::endl;
+            source = CARD_TEXTURE_PATH_PREFIX;
+            this->loadCardAtlasFromImages();
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started);
+        std::cerr << "Loaded the cards from " << source << " in " << elapsed.count() << " ms" << std::endl;
+    }
+
+    void GraphicalGame::loadCardAtlasFromPack(const char *path) {
+        AssetPack pack(path);
+        auto region = [&](const std::string& name) {
+            AssetPack::Region found;
+            if (!pack.find(name, found)) {
+                throw InvalidAssetPackException(std::string(path) + " has no image " + name);
+            }
+            return Rectangle {
+                static_cast<float>(found.x),
+                static_cast<float>(found.y),
+                static_cast<float>(found.width),
+                static_cast<float>(found.height)
+            };
+        };
+
+        for (std::size_t i = 0; i < Card::DECK_SIZE; i++) {
+            this->cardAtlasRegions[i] = region(cardImageName(Card::fromIndex(i)));
+        }
+        std::string backName(CARD_BACK_TEXTURE_PATH_SUFFIX);
+        backName.erase(backName.rfind('.'));
+        this->cardBackAtlasRegion = region(backName);
+
+        // the pixels are uploaded straight from the mapped file, which is unmapped once they are on the GPU
+        Image atlas = {
+            const_cast<unsigned char *>(pack.atlasPixels()),
+            static_cast<int>(pack.atlasWidth()),
+            static_cast<int>(pack.atlasHeight()),
+            1,
+            PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+        };
+        this->cardAtlas = LoadTextureFromImage(atlas);
+    }
+
+    void GraphicalGame::loadCardAtlasFromImages() {
+        // the card faces in Card::index() order, then the back
+        std::string basePath(CARD_TEXTURE_PATH_PREFIX);
+        std::vector<std::string> paths;
+        for (std::size_t i = 0; i < Card::DECK_SIZE; i++) {
+            paths.push_back(basePath + cardImageName(Card::fromIndex(i)) + ".png");
+        }
+        paths.push_back(basePath + CARD_BACK_TEXTURE_PATH_SUFFIX);
+
+        // decoding is CPU work and spread over a few threads; only uploading to the GPU
+        // has to happen on the thread that owns the window
+        std::vector<Image> images(paths.size());
+        std::atomic<std::size_t> nextImage {0};
+        auto decode = [&]() {
+            std::size_t i;
+            while ((i = nextImage.fetch_add(1, std::memory_order_relaxed)) < paths.size()) {
+                images[i] = LoadImage(paths[i].c_str());
+                ImageFormat(&images[i], PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            }
+        };
+        std::size_t workers = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), paths.size());
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < workers; i++) {
+            threads.emplace_back(decode);
+        }
+        decode();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        const Image& back = images.back();
+        float width = back.width;
+        float height = back.height;
+
+        // one row per suit with the faces in order, so a card's slot follows from Card::index(),
+        // then a last row for the back
+        const std::size_t columns = static_cast<std::size_t>(Face::COUNT);
+        const std::size_t rows = static_cast<std::size_t>(Suit::COUNT) + 1;
+        Image atlas = GenImageColor(columns * back.width, rows * back.height, BLANK);
+        for (std::size_t i = 0; i < Card::DECK_SIZE; i++) {
+            Rectangle slot = {(i % columns) * width, (i / columns) * height, width, height};
+            Rectangle source = {0, 0, static_cast<float>(images[i].width), static_cast<float>(images[i].height)};
+            ImageDraw(&atlas, images[i], source, slot, WHITE);
+            this->cardAtlasRegions[i] = slot;
+        }
+        this->cardBackAtlasRegion = {0, (rows - 1) * height, width, height};
+        ImageDraw(&atlas, back, Rectangle {0, 0, width, height}, this->cardBackAtlasRegion, WHITE);
+        for (Image& image : images) {
+            UnloadImage(image);
+        }
+
+        this->cardAtlas = LoadTextureFromImage(atlas);
+        UnloadImage(atlas);
+    }
+
     GraphicalGame::GraphicalGame(std::minstd_rand::result_type seed): GraphicalGame() {
-        auto rand = std::minstd_rand(seed);
-        this->game = Game::createAndDealGame(rand);
+        this->game = Game::createFromSeed(seed);
+        this->recording = std::make_unique<InputRecording>(
+            static_cast<std::uint32_t>(seed),
+            static_cast<std::uint8_t>(this->game->getDrawCount()),
+            static_cast<std::uint16_t>(this->cardBackAtlasRegion.width),
+            static_cast<std::uint16_t>(this->cardBackAtlasRegion.height)
+        );
+    }
+
+    std::unique_ptr<GraphicalGame> GraphicalGame::createForReplay(const InputRecording& recording) {
+        Vector2 cardSize = {
+            static_cast<float>(recording.getCardWidth()),
+            static_cast<float>(recording.getCardHeight())
+        };
+        std::unique_ptr<GraphicalGame> ggame(new GraphicalGame(cardSize));
+        config::wasteDifficulty difficulty = recording.getDrawCount() == 3
+            ? config::wasteDifficulty::THREE
+            : config::wasteDifficulty::ONE;
+        ggame->game = Game::createFromSeed(recording.getSeed(), difficulty);
+        return ggame;
+    }
+
+    void GraphicalGame::replay(const InputRecording& recording) {
+        for (const InputEvent& event : recording.getEvents()) {
+            Vector2 position = {event.x, event.y};
+            switch (event.type) {
+                case InputEventType::PRESS:
+                    this->handleMousePress(position, event.time);
+                    break;
+                case InputEventType::DRAG:
+                    this->handleDrag(position, event.time);
+                    break;
+                case InputEventType::RELEASE:
+                    this->handleMouseRelease(position, event.time);
+                    break;
+                case InputEventType::UNDO:
+                    this->undo(event.time);
+                    break;
+                case InputEventType::REDO:
+                    this->redo(event.time);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    std::unique_ptr<GraphicalGame> GraphicalGame::resume(const char *path) {
+        Game::SaveData data;
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file.read(reinterpret_cast<char *>(data.data()), data.size())) {
+            return nullptr;
+        }
+        std::unique_ptr<GraphicalGame> ggame(new GraphicalGame());
+        ggame->game = Game::createFromSave(data);
+        return ggame;
+    }
+
+    void GraphicalGame::save(const char *path) {
+        if (this->game->isWon()) {
+            std::remove(path);
+            return;
+        }
+        if (this->isDragging()) {
+            this->cancelDrag();
+        }
+        Game::SaveData data;
+        this->game->save(data);
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(data.data()), data.size());
+        if (!file) {
+            throw std::runtime_error(std::string("Cannot write ") + path);
+        }
+    }
+
+    const InputRecording *GraphicalGame::getRecording() const {
+        return this->recording.get();
+    }
+
+    const Game& GraphicalGame::getGame() const {
+        return *this->game;
     }
 
     int stackPxSize(int nFaceDown, int nFaceUp, int cardHeight) {
@@ -75,7 +269,7 @@ namespace solitaire {
         this->wasteRegion = {
             this->stockRegion.x + this->stockRegion.width + TINY_SPACING,
             stockY,
-            static_cast<float>(this->cardWidth()),
+            static_cast<float>(this->cardWidth() + (MAX_WASTE_FAN_SIZE - 1) * WASTE_FAN_DISPLACEMENT),
             static_cast<float>(this->cardHeight())
         };
 
@@ -119,27 +313,28 @@ namespace solitaire {
         currFoundationRegion.width = this->cardWidth();
         currFoundationRegion.height = this->cardHeight();
         for (Suit i = Suit::FIRST; i < Suit::END; i++) {
-            this->foundationRegions.emplace(i, currFoundationRegion);
+            this->foundationRegions[i] = currFoundationRegion;
             currFoundationRegion.x += currFoundationRegion.width + foundationsSpacing;
         }
     }
 
-    void GraphicalGame::renderCardTexture(const Texture& texture, Vector2 position, Color color) {
-        DrawTextureEx(texture, position, 0, CARD_SCALE, color);
+    void GraphicalGame::renderAtlasRegion(Rectangle source, Vector2 position, Color color) {
+        Rectangle dest = {position.x, position.y, source.width * CARD_SCALE, source.height * CARD_SCALE};
+        this->profiler.countDraw(this->cardAtlas.id);
+        DrawTexturePro(this->cardAtlas, source, dest, Vector2 {0, 0}, 0, color);
     }
 
-    void GraphicalGame::renderCard(const Card& card, Vector2 position) {
-        auto tex = this->cardTextures.at(std::make_pair(card.suit, card.face));
-        this->renderCardTexture(tex, position);
+    void GraphicalGame::renderCard(const Card& card, Vector2 position, Color color) {
+        this->renderAtlasRegion(this->cardAtlasRegions[card.index()], position, color);
     }
 
-    void GraphicalGame::renderCardFaceDown(Vector2 position) {
-        this->renderCardTexture(this->cardBackTexture, position);
+    void GraphicalGame::renderCardFaceDown(Vector2 position, Color color) {
+        this->renderAtlasRegion(this->cardBackAtlasRegion, position, color);
     }
 
     void GraphicalGame::renderCardPileFaceUp(const CardPile& pile, Vector2 position) {
         for (auto card = pile.rbegin(); card != pile.rend(); card++) {
-            this->renderCard(**card, position);
+            this->renderCard(*card, position);
             position.y += STACKED_DISPLACEMENT;
         }
     }
@@ -156,38 +351,54 @@ namespace solitaire {
         if (this->game->hasStock()) {
             this->renderCardFaceDown(pos);
         } else {
-            this->renderCardTexture(this->cardBackTexture, pos, TRANSPARENT_CARD_COLOR);
+            this->renderCardFaceDown(pos, TRANSPARENT_CARD_COLOR);
         }
     }
 
+    std::size_t GraphicalGame::wasteFanSize() {
+        std::size_t fan = std::min<std::size_t>(this->game->getDrawCount(), MAX_WASTE_FAN_SIZE);
+        return std::min(fan, this->game->getWaste().size());
+    }
+
+    Rectangle GraphicalGame::wasteTopRegion() {
+        Rectangle region = this->wasteRegion;
+        region.width = this->cardWidth();
+        if (this->wasteFanSize() > 1) {
+            region.x += (this->wasteFanSize() - 1) * WASTE_FAN_DISPLACEMENT;
+        }
+        return region;
+    }
+
     void GraphicalGame::renderWaste() {
-        auto wasteTop = this->game->peekWaste();
-        if (wasteTop != nullptr) {
-            this->renderCard(*wasteTop, RectOrigin(this->wasteRegion));
+        const CardPile& waste = this->game->getWaste();
+        Vector2 position = RectOrigin(this->wasteRegion);
+        for (std::size_t i = this->wasteFanSize(); i-- > 0;) {
+            this->renderCard(*waste.peek(i), position);
+            position.x += WASTE_FAN_DISPLACEMENT;
         }
     }
 
     void GraphicalGame::renderTableaus() {
         for (int i = 0; i < NUM_TABLEAUS; i++) {
             Vector2 currTableauPosition = RectOrigin(this->tableauRegions.at(i));
-            this->renderCardTexture(this->cardBackTexture, currTableauPosition, Fade(BLACK, 0.3));
+            this->renderCardFaceDown(currTableauPosition, Fade(BLACK, 0.3));
             this->renderCardPileFaceDown(this->game->getClosedTableauSize(i), currTableauPosition);
             this->renderCardPileFaceUp(this->game->getOpenTableau(i), currTableauPosition);
         }
     }
 
     void GraphicalGame::renderUI() {
+        this->profiler.countDraw(GetFontDefault().texture.id);
         DrawText(TextFormat("Moves: %i", this->game->getMoveCount()), 20, 20, 30, BLACK);
     }
 
     void GraphicalGame::renderFoundations() {
         for (Suit s = Suit::FIRST; s < Suit::END; s++) {
-            Rectangle region = this->foundationRegions.at(s);
+            Rectangle region = this->foundationRegions[s];
             Vector2 position = RectOrigin(region);
             const Card *foundationTop = this->game->peekFoundation(s);
             if (foundationTop == nullptr) {
-                Texture ace = this->cardTextures.at(std::make_pair(s, Face::ACE));
-                this->renderCardTexture(ace, position, TRANSPARENT_CARD_COLOR);
+                this->renderCard(Card(Face::ACE, s), position, TRANSPARENT_CARD_COLOR);
             } else {
                 this->renderCard(*foundationTop, position);
             }
@@ -203,23 +414,215 @@ namespace solitaire {
     }
 
     void GraphicalGame::update() {
-        frame++;
+        // held cards still count as lying where they came from, so only moves change the hash
+        if (this->hints && !this->isDragging() && this->game->getHash() != this->hintedHash) {
+            this->hints->submit(*this->game);
+            this->hintedHash = this->game->getHash();
+            this->showHint = false;
+        }
     }
 
-    void GraphicalGame::render() {
+    void GraphicalGame::requestHint() {
+        if (this->isDragging()) {
+            return; // the engine is only given positions without held cards
+        }
+        if (!this->hints) {
+            this->hints = std::make_unique<HintEngine>(std::chrono::milliseconds(config::hintMilliseconds));
+            this->hints->submit(*this->game);
+            this->hintedHash = this->game->getHash();
+        }
+        this->showHint = true;
+    }
+
+    bool GraphicalGame::isWaitingForHint() const {
+        Move move;
+        return this->showHint && this->hints->latest(move) == HintStatus::PENDING;
+    }
+
+    void GraphicalGame::renderBoard() {
+        ClearBackground(BACKGROUND_COLOR);
         this->renderStock();
         this->renderWaste();
         this->renderTableaus();
         this->renderFoundations();
-        this->renderHeldCards();
         this->renderUI();
     }
 
+    void GraphicalGame::render() {
+        if (this->boardDirty) {
+            BeginTextureMode(this->boardLayer);
+                // colors blend as usual, but alpha only ever adds up, so translucent cards leave
+                // the layer opaque instead of blending with the screen a second time when drawn
+                rlSetBlendFactorsSeparate(
+                    RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA,
+                    RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+                    RL_FUNC_ADD, RL_FUNC_ADD
+                );
+                BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+                    this->renderBoard();
+                EndBlendMode();
+            EndTextureMode();
+            this->boardDirty = false;
+        }
+        // render textures are stored upside down, so the source rectangle flips it back
+        Rectangle source = {
+            0,
+            0,
+            static_cast<float>(this->boardLayer.texture.width),
+            -static_cast<float>(this->boardLayer.texture.height)
+        };
+        this->profiler.countDraw(this->boardLayer.texture.id);
+        DrawTextureRec(this->boardLayer.texture, source, Vector2 {0, 0}, WHITE);
+        this->renderHeldCards();
+        if (this->showHint) {
+            this->renderHint();
+        }
+        if (this->showProfiler) {
+            this->renderProfilerOverlay();
+        }
+    }
+
+    void GraphicalGame::renderProfilerOverlay() {
+        // drawn last and left out of the counts, so showing it changes the numbers as little as possible
+        static const EnumArray<FramePhase, Color> phaseColors = [] {
+            EnumArray<FramePhase, Color> colors;
+            colors[FramePhase::INPUT] = SKYBLUE;
+            colors[FramePhase::UPDATE] = YELLOW;
+            colors[FramePhase::RENDER] = ORANGE;
+            colors[FramePhase::PRESENT] = LIGHTGRAY;
+            return colors;
+        }();
+        const int fontSize = 10;
+        const int lineHeight = 14;
+        const int barWidth = 2;
+        const float pixelsPerMs = 4; // 25 ms fills the graph
+        const int graphHeight = 100;
+        const int padding = 8;
+        const int width = static_cast<int>(FrameProfiler::HISTORY) * barWidth + 2 * padding;
+        const int height = 8 * lineHeight + graphHeight + 3 * padding;
+        const int left = static_cast<int>(this->actualResolution.x) - width - padding;
+        const int top = padding;
+
+        DrawRectangle(left, top, width, height, Fade(BLACK, 0.75f));
+        int x = left + padding;
+        int y = top + padding;
+        DrawText(TextFormat("last %i frames, ms       p50     p95     p99     max", static_cast<int>(this->profiler.recentFrames())),
+            x, y, fontSize, WHITE);
+        y += lineHeight;
+
+        auto drawRow = [&](const char *name, FrameProfiler::Percentiles p, Color color) {
+            DrawText(TextFormat("%-8s %7.2f %7.2f %7.2f %7.2f", name, p.p50, p.p95, p.p99, p.max), x, y, fontSize, color);
+            y += lineHeight;
+        };
+        drawRow("frame", this->profiler.recentFramePercentiles(), WHITE);
+        for (FramePhase phase = FramePhase::FIRST; phase < FramePhase::END; phase++) {
+            drawRow(framePhaseToString(phase), this->profiler.recentPercentiles(phase), phaseColors[phase]);
+        }
+        // handled-to-present, over the frames that handled input
+        drawRow("handled", this->profiler.recentInputPercentiles(), WHITE);
+
+        std::size_t frames = this->profiler.recentFrames();
+        if (frames > 0) {
+            const FrameProfiler::Frame& latest = this->profiler.recentFrame(frames - 1);
+            DrawText(TextFormat("draw calls %u, texture binds %u", latest.drawCalls, latest.textureBinds),
+                x, y, fontSize, WHITE);
+        }
+        y += lineHeight + padding;
+
+        // one stacked bar per frame, newest on the right
+        int bottom = y + graphHeight;
+        for (std::size_t i = 0; i < frames; i++) {
+            const FrameProfiler::Frame& frame = this->profiler.recentFrame(i);
+            int barX = x + static_cast<int>(FrameProfiler::HISTORY - frames + i) * barWidth;
+            float barBottom = static_cast<float>(bottom);
+            for (FramePhase phase = FramePhase::FIRST; phase < FramePhase::END; phase++) {
+                float barHeight = std::min(frame.milliseconds[phase] * pixelsPerMs, barBottom - y);
+                barBottom -= barHeight;
+                DrawRectangle(barX, static_cast<int>(barBottom), barWidth, static_cast<int>(std::ceil(barHeight)), phaseColors[phase]);
+            }
+        }
+        // a 60 fps frame budget for reference
+        int budgetY = bottom - static_cast<int>(1000.0f / 60 * pixelsPerMs);
+        DrawLine(x, budgetY, x + static_cast<int>(FrameProfiler::HISTORY) * barWidth, budgetY, RED);
+    }
+
+    Rectangle GraphicalGame::tableauCardsRegion(std::size_t which, std::size_t count) {
+        // the top count open cards of the tableau, or its empty slot above the closed cards
+        Rectangle region = this->tableauRegions.at(which);
+        std::size_t nOpen = this->game->getOpenTableau(which).size();
+        region.y += this->game->getClosedTableauSize(which) * FACE_DOWN_STACKED_DISPLACEMENT;
+        region.y += (nOpen - std::min(count, nOpen)) * STACKED_DISPLACEMENT;
+        region.height = (std::max<std::size_t>(count, 1) - 1) * STACKED_DISPLACEMENT + this->cardHeight();
+        return region;
+    }
+
+    Rectangle GraphicalGame::hintSourceRegion(const Move& move) {
+        switch (move.type) {
+            case MoveType::TURN_STOCK:
+            case MoveType::RECYCLE_WASTE:
+                return this->stockRegion;
+            case MoveType::WASTE_TO_TABLEAU:
+            case MoveType::WASTE_TO_FOUNDATION:
+                return this->wasteTopRegion();
+            case MoveType::FOUNDATION_TO_TABLEAU:
+                return this->foundationRegions[static_cast<Suit>(move.from)];
+            case MoveType::TURN_CLOSED_TABLEAU: {
+                Rectangle lastClosedCard = this->tableauRegions.at(move.from);
+                lastClosedCard.y += (this->game->getClosedTableauSize(move.from) - 1) * FACE_DOWN_STACKED_DISPLACEMENT;
+                lastClosedCard.height = this->cardHeight();
+                return lastClosedCard;
+            }
+            default:
+                return this->tableauCardsRegion(move.from, move.count);
+        }
+    }
+
+    Rectangle GraphicalGame::hintTargetRegion(const Move& move) {
+        switch (move.type) {
+            case MoveType::WASTE_TO_FOUNDATION:
+            case MoveType::TABLEAU_TO_FOUNDATION:
+                return this->foundationRegions[static_cast<Suit>(move.to)];
+            case MoveType::WASTE_TO_TABLEAU:
+            case MoveType::TABLEAU_TO_TABLEAU:
+            case MoveType::FOUNDATION_TO_TABLEAU:
+                return this->tableauCardsRegion(move.to, 1);
+            default:
+                return this->hintSourceRegion(move); // moves without a target are played by clicking their source
+        }
+    }
+
+    void GraphicalGame::renderHint() {
+        Move move;
+        HintStatus status = this->hints->latest(move);
+        const char *text = nullptr;
+        if (status == HintStatus::PENDING) {
+            text = "Looking for a hint...";
+        } else if (status == HintStatus::NO_WIN) {
+            text = "No winning line from here";
+        } else if (status == HintStatus::WON) {
+            text = "The game is won";
+        }
+        if (text != nullptr) {
+            this->profiler.countDraw(GetFontDefault().texture.id);
+            DrawText(text, 20, 60, 30, BLACK);
+            return;
+        }
+
+        // gold for a line known to win, white for the solver's best guess
+        Color color = status == HintStatus::WINNING ? GOLD : WHITE;
+        Rectangle source = this->hintSourceRegion(move);
+        Rectangle target = this->hintTargetRegion(move);
+        this->profiler.countDraw(GetShapesTexture().id);
+        DrawRectangleLinesEx(source, 4, color);
+        this->profiler.countDraw(GetShapesTexture().id);
+        DrawRectangleLinesEx(target, 4, color);
+    }
+
     void GraphicalGame::clickStock() {
         if (this->game->hasStock()) {
-            this->game->turnStock();
+            this->journal.record(this->game->turnStock());
         } else {
-            this->game->returnWasteToStock();
+            this->journal.record(this->game->returnWasteToStock());
         }
     }
 
@@ -227,13 +630,13 @@ namespace solitaire {
         if (!this->game->hasWaste()) {
             return;
         }
+        Vector2 topOrigin = RectOrigin(this->wasteTopRegion());
         this->game->takeWaste();
-        this->clickStart = this->frame;
-        this->dragOffset = Vector2Subtract(mousePosition, RectOrigin(this->wasteRegion));
+        this->dragOffset = Vector2Subtract(mousePosition, topOrigin);
     }
 
     void GraphicalGame::clickFoundation(Suit foundationSuit, Vector2 mousePosition) {
-        auto foundationRegion = this->foundationRegions.at(foundationSuit);
+        auto foundationRegion = this->foundationRegions[foundationSuit];
         if (this->game->hasFoundation(foundationSuit)) {
             this->game->takeFoundation(foundationSuit);
             this->dragOffset = Vector2Subtract(mousePosition, RectOrigin(foundationRegion));
@@ -252,10 +655,9 @@ namespace solitaire {
             lastClosedCard.height = this->cardHeight();
             lastClosedCard.y += (nClosedCards - 1) * FACE_DOWN_STACKED_DISPLACEMENT;
             if (CheckCollisionPointRec(mousePosition, lastClosedCard)) {
-                this->game->turnClosedTableauTop(tableauIndex);
+                this->journal.record(this->game->turnClosedTableauTop(tableauIndex));
             }
         } else {
-            this->clickStart = this->frame;
             int openCardsStart = closedCardsStart + nClosedCards * FACE_DOWN_STACKED_DISPLACEMENT;
             int nCardsDown = floor((mousePosition.y - openCardsStart) / STACKED_DISPLACEMENT);
             if (nCardsDown < 0) { // if clicking hidden cards under shown tableau.
@@ -277,20 +679,25 @@ namespace solitaire {
         }
     }
 
-    void GraphicalGame::handleMousePress(Vector2 mousePosition) {
+    void GraphicalGame::handleMousePress(Vector2 mousePosition, double time) {
+        if (this->recording) {
+            time = this->recording->add(InputEventType::PRESS, time, mousePosition.x, mousePosition.y);
+        }
+        this->boardDirty = true;
+        this->clickStart = time;
         if (CheckCollisionPointRec(mousePosition, this->stockRegion)) {
             this->clickStock();
             return;
         }
 
-        if (CheckCollisionPointRec(mousePosition, this->wasteRegion)) {
+        if (CheckCollisionPointRec(mousePosition, this->wasteTopRegion())) {
             this->clickWaste(mousePosition);
             return;
         }
 
         if (CheckCollisionPointRec(mousePosition, this->foundationMacroRegion)) {
             for (Suit s = Suit::FIRST; s < Suit::END; s++) {
-                auto suitRegion = this->foundationRegions.at(s);
+                auto suitRegion = this->foundationRegions[s];
                 if (CheckCollisionPointRec(mousePosition, suitRegion)) {
                     this->clickFoundation(s, mousePosition);
                     return;
@@ -310,12 +717,16 @@ namespace solitaire {
         }
     }
 
-    void GraphicalGame::handleMouseRelease(Vector2 mousePosition) {
+    void GraphicalGame::handleMouseRelease(Vector2 mousePosition, double time) {
+        if (this->recording) {
+            time = this->recording->add(InputEventType::RELEASE, time, mousePosition.x, mousePosition.y);
+        }
         if (this->game->getHeldCards().empty()) {
             return;
         }
+        this->boardDirty = true;
 
-        if (this->frame - this->clickStart <= config::framesToIgnoreClick) {
+        if (time - this->clickStart <= config::secondsToIgnoreClick) {
             // if the 'drag' was only a fast click.
             this->handleClick(mousePosition);
             return;
@@ -324,7 +735,12 @@ namespace solitaire {
         this->releaseDrag(mousePosition);
     }
 
-    void GraphicalGame::handleDrag(Vector2 mousePosition) {
+    void GraphicalGame::handleDrag(Vector2 mousePosition, double time) {
+        // the mouse is sampled every frame it is down; only moves change anything
+        bool moved = mousePosition.x != this->dragPosition.x || mousePosition.y != this->dragPosition.y;
+        if (this->recording && moved) {
+            this->recording->add(InputEventType::DRAG, time, mousePosition.x, mousePosition.y);
+        }
         this->dragPosition = mousePosition;
     }
 
@@ -333,7 +749,7 @@ namespace solitaire {
         int holdSize = this->game->getHeldCards().size();
         if (holdSize > 1 && config::autoplayFromTableau) {
             // if stack only check tableau
-            this->game->attemptHeldToTableau();
+            this->journal.record(this->game->attemptHeldToTableau());
             if (!this->game->getHeldCards().empty()) {
                 this->cancelDrag();
             }
@@ -342,21 +758,21 @@ namespace solitaire {
 
         if (holdSize == 1) {
             if (config::autoplayToFoundation) {
-                this->game->attemptHeldToFoundation();
+                this->journal.record(this->game->attemptHeldToFoundation());
             }
 
             if (config::autoplayFromWaste
                 && CheckCollisionPointRec(mousePosition, this->wasteRegion)
                 && !this->game->getHeldCards().empty()
             ) {
-                this->game->attemptHeldToTableau();
+                this->journal.record(this->game->attemptHeldToTableau());
             }
 
             if (config::autoplayFromTableau
                 && !this->game->getHeldCards().empty()
                 && CheckCollisionPointRec(mousePosition, this->tableauMacroRegion)
             ) {
-                this->game->attemptHeldToTableau();
+                this->journal.record(this->game->attemptHeldToTableau());
             }
         }
 
@@ -369,14 +785,15 @@ namespace solitaire {
 
     void GraphicalGame::releaseDrag(Vector2 mousePosition) {
         for (Suit s = Suit::FIRST; s < Suit::END; s++) {
-            float score = this->cardDragOverlapScore(this->foundationRegions.at(s));
+            float score = this->cardDragOverlapScore(this->foundationRegions[s]);
             if (score >= CARD_SLOT_MIN_OVERLAP_AREA) {
-                try {
-                    this->game->stackFoundation(s);
-                } catch (const std::exception& e) {
+                MoveRecord record {};
+                PlacementResult result = this->game->tryStackFoundation(s, &record);
+                this->journal.record(record);
+                if (result != PlacementResult::OK) {
                     std::cerr << "Could not stack " << *this->game->getHeldCards().peekBase();
                     std::cerr << " onto foundation " << s << ": ";
-                    std::cerr << e.what() << std::endl;
+                    std::cerr << placementResultToString(result) << std::endl;
                     this->cancelDrag();
                 }
                 return;
@@ -386,12 +803,13 @@ namespace solitaire {
         for (std::size_t i = 0; i < NUM_TABLEAUS; i++) {
             float score = this->cardDragOverlapScore(this->tableauRegions.at(i));
             if (score >= CARD_SLOT_MIN_OVERLAP_AREA) {
-                try {
-                    this->game->stackTableau(i);
-                } catch (const std::exception& e) {
+                MoveRecord record {};
+                PlacementResult result = this->game->tryStackTableau(i, &record);
+                this->journal.record(record);
+                if (result != PlacementResult::OK) {
                     std::cerr << "Could not stack " << *this->game->getHeldCards().peekBase();
                     std::cerr << " onto tableau " << i << ": ";
-                    std::cerr << e.what() << std::endl;
+                    std::cerr << placementResultToString(result) << std::endl;
                     this->cancelDrag();
                 }
                 return;
@@ -405,14 +823,52 @@ namespace solitaire {
         this->game->returnHeldCards();
     }
 
+    bool GraphicalGame::isDragging() const {
+        return !this->game->getHeldCards().empty();
+    }
+
+    void GraphicalGame::undo(double time) {
+        if (this->recording) {
+            this->recording->add(InputEventType::UNDO, time);
+        }
+        if (!this->game->getHeldCards().empty()) {
+            return;
+        }
+        if (this->journal.undo(*this->game)) {
+            this->boardDirty = true;
+        }
+    }
+
+    void GraphicalGame::redo(double time) {
+        if (this->recording) {
+            this->recording->add(InputEventType::REDO, time);
+        }
+        if (!this->game->getHeldCards().empty()) {
+            return;
+        }
+        if (this->journal.redo(*this->game)) {
+            this->boardDirty = true;
+        }
+    }
+
+    FrameProfiler& GraphicalGame::getProfiler() {
+        return this->profiler;
+    }
+
+    void GraphicalGame::toggleProfilerOverlay() {
+        this->showProfiler = !this->showProfiler;
+    }
+
+    bool GraphicalGame::isProfilerOverlayShown() const {
+        return this->showProfiler;
+    }
+
     float GraphicalGame::cardWidth() {
-        static float w = CARD_SCALE * this->cardBackTexture.width;
-        return w;
+        return CARD_SCALE * this->cardBackAtlasRegion.width;
     }
 
     float GraphicalGame::cardHeight() {
-        static float h = CARD_SCALE * this->cardBackTexture.height;
-        return h;
+        return CARD_SCALE * this->cardBackAtlasRegion.height;
     }
 
     float GraphicalGame::cardArea() {
@@ -420,7 +876,7 @@ namespace solitaire {
     }
 
     float GraphicalGame::cardDragOverlapScore(Rectangle region) {
-        static float maxScore = this->cardArea();
+        float maxScore = this->cardArea();
         Vector2 currentCardDragOrigin = Vector2Subtract(this->dragPosition, this->dragOffset);
         Rectangle currentCardDrag = {
             currentCardDragOrigin.x,
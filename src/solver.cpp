@@ -0,0 +1,796 @@
+#include "solver.hpp"
+#include "slt.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace solitaire {
+    const char *solveStatusToString(SolveStatus status) noexcept {
+        switch (status) {
+            case SolveStatus::SOLVED: return "solved";
+            case SolveStatus::UNSOLVABLE: return "unsolvable";
+            case SolveStatus::UNKNOWN: return "unknown";
+        }
+        return "invalid";
+    }
+
+    TranspositionTable::TranspositionTable(unsigned bits):
+        slots(std::size_t(1) << bits, 0),
+        mask((std::size_t(1) << bits) - 1),
+        maxUsed((std::size_t(1) << bits) / 4 * 3) {}
+
+    TranspositionTable::InsertResult TranspositionTable::insert(std::uint64_t hash) noexcept {
+        if (hash == 0) hash = 1; // 0 marks empty slots
+        std::size_t i = static_cast<std::size_t>(hash) & this->mask;
+        while (this->slots[i] != 0) {
+            if (this->slots[i] == hash) {
+                return InsertResult::PRESENT;
+            }
+            i = (i + 1) & this->mask;
+        }
+        if (this->used >= this->maxUsed) {
+            return InsertResult::FULL;
+        }
+        this->slots[i] = hash;
+        this->used++;
+        return InsertResult::INSERTED;
+    }
+
+    void TranspositionTable::clear() noexcept {
+        std::fill(this->slots.begin(), this->slots.end(), 0);
+        this->used = 0;
+    }
+
+    std::size_t TranspositionTable::size() const noexcept {
+        return this->used;
+    }
+
+    static int foundationLevel(const Game& game, Suit s) {
+        const Card *top = game.peekFoundation(s);
+        return top == nullptr ? 0 : static_cast<int>(top->face());
+    }
+
+    /**
+     * @brief Checks if putting card on its foundation can never hurt.
+     * A card is only ever needed on the tableau to hold the two cards of the opposite
+     * color one rank below it, so once those are on their foundations it is safe to play.
+     */
+    static bool isSafeToFoundation(const Game& game, Card card) {
+        int face = static_cast<int>(card.face());
+        if (face <= static_cast<int>(Face::TWO)) {
+            return true;
+        }
+        for (Suit s = Suit::FIRST; s < Suit::END; s++) {
+            if (suitsCanAlternate(s, card.suit()) && foundationLevel(game, s) < face - 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static const Card *movedCard(const Game& game, const Move& move) {
+        switch (move.type) {
+            case MoveType::WASTE_TO_FOUNDATION:
+                // with more than one card drawn, playing the waste top regroups the rest of the stock
+                return game.getDrawCount() == 1 ? game.peekWaste() : nullptr;
+            case MoveType::TABLEAU_TO_FOUNDATION:
+                return game.getOpenTableau(move.from).peek();
+            default:
+                return nullptr;
+        }
+    }
+
+    /// @return The priority of a move, or a negative value if it can be dropped.
+    static int scoreMove(const Game& game, const Move& move) {
+        switch (move.type) {
+            case MoveType::TURN_CLOSED_TABLEAU:
+                return 100;
+            case MoveType::TABLEAU_TO_FOUNDATION: {
+                bool exposes = game.getOpenTableau(move.from).size() == 1
+                    && game.getClosedTableauSize(move.from) > 0;
+                return exposes ? 90 : 60;
+            }
+            case MoveType::WASTE_TO_FOUNDATION:
+                return 55;
+            case MoveType::TABLEAU_TO_TABLEAU: {
+                std::size_t openSize = game.getOpenTableau(move.from).size();
+                std::size_t closedSize = game.getClosedTableauSize(move.from);
+                if (move.count < openSize) {
+                    return 10; // only useful to free the card it was sitting on
+                }
+                if (closedSize > 0) {
+                    return 70 + static_cast<int>(closedSize); // dig into the deepest piles first
+                }
+                if (game.getOpenTableau(move.to).empty()) {
+                    return -1; // a king moving between empty tableaus
+                }
+                return 30;
+            }
+            case MoveType::WASTE_TO_TABLEAU:
+                return 40;
+            case MoveType::TURN_STOCK:
+                return 5;
+            case MoveType::RECYCLE_WASTE:
+                return 4;
+            case MoveType::FOUNDATION_TO_TABLEAU: {
+                // only worth it to hold a card of the opposite color one rank lower
+                int face = foundationLevel(game, static_cast<Suit>(move.from));
+                for (Suit s = Suit::FIRST; s < Suit::END; s++) {
+                    if (suitsCanAlternate(s, static_cast<Suit>(move.from)) && foundationLevel(game, s) < face - 1) {
+                        return 0;
+                    }
+                }
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    void expandStockTurns(const Game& game, MoveBuffer& moves) noexcept {
+        for (std::size_t i = 0; i < moves.size(); i++) {
+            if (moves[i].type != MoveType::TURN_STOCK) continue;
+
+            moves[i] = moves[moves.size() - 1];
+            moves.truncate(moves.size() - 1);
+            game.generateStockJumps(moves);
+            return;
+        }
+    }
+
+    void orderMoves(const Game& game, MoveBuffer& moves) noexcept {
+        for (const Move& move : moves) {
+            const Card *card = movedCard(game, move);
+            if (card != nullptr && isSafeToFoundation(game, *card)) {
+                Move safe = move;
+                moves.clear();
+                moves.push(safe);
+                return;
+            }
+        }
+
+        int scores[MoveBuffer::CAPACITY];
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < moves.size(); i++) {
+            int score = scoreMove(game, moves[i]);
+            if (score < 0) continue;
+
+            // insertion sort, highest score first, ties in generation order
+            std::size_t j = kept++;
+            Move move = moves[i];
+            while (j > 0 && scores[j - 1] < score) {
+                scores[j] = scores[j - 1];
+                moves[j] = moves[j - 1];
+                j--;
+            }
+            scores[j] = score;
+            moves[j] = move;
+        }
+        moves.truncate(kept);
+    }
+
+    namespace {
+        constexpr std::size_t NO_SLOT = SIZE_MAX;
+
+        struct Frame {
+            MoveBuffer moves;
+            std::size_t next = 0;
+            MoveRecord played {}; // the move currently being explored from this frame
+            std::uint64_t hash = 0; // of the position this frame expands
+            std::size_t slot = NO_SLOT; // where a shared table keeps that position
+            std::uint32_t order = 0; // when the search reached this frame
+            std::uint32_t low = 0; // the earliest frame still on the path the search below led back to
+            bool unproven = false; // the search below relied on positions it did not settle
+        };
+
+        enum class Visit {
+            NEW, // search below the position
+            SEEN, // skip the position
+            FULL // the table cannot take it, stop searching
+        };
+
+        enum class SearchOutcome {
+            WON,
+            EXHAUSTED,
+            STOPPED
+        };
+
+        void expandFrame(const Game& game, Frame& frame) noexcept {
+            game.generateMoves(frame.moves);
+            expandStockTurns(game, frame.moves);
+            orderMoves(game, frame.moves);
+            frame.next = 0;
+            frame.hash = game.getHash();
+        }
+
+        /**
+         * @brief Runs a depth-first search below the position game is in.
+         * On WON, the played moves of path lead from the start to a win; otherwise
+         * game is left as it might be anywhere along the way.
+         * @param probe Called as probe(hash, path) for every new position, returns a Visit.
+         * The position's frame is already the last one in path, and is dropped unless the result is NEW.
+         * @param poll Called after every expanded node with the total count, returns true to stop.
+         * @param retire Called with path when every move of its last frame has been searched, just before it is dropped.
+         */
+        template <typename Probe, typename Poll, typename Retire>
+        SearchOutcome depthFirst(
+            Game& game,
+            std::vector<Frame>& path,
+            std::uint64_t& nodes,
+            Probe&& probe,
+            Poll&& poll,
+            Retire&& retire
+        ) {
+            path.clear();
+            path.emplace_back();
+            expandFrame(game, path.back());
+
+            while (!path.empty()) {
+                Frame& frame = path.back();
+                if (frame.next == frame.moves.size()) {
+                    retire(path);
+                    path.pop_back();
+                    if (!path.empty()) {
+                        game.revert(path.back().played);
+                    }
+                    continue;
+                }
+
+                frame.played = game.apply(frame.moves[frame.next++]);
+                nodes++;
+                if (game.isWon()) {
+                    return SearchOutcome::WON;
+                }
+                if (poll(nodes)) {
+                    return SearchOutcome::STOPPED;
+                }
+
+                path.emplace_back();
+                Visit visit = probe(game.getHash(), path);
+                if (visit == Visit::SEEN) {
+                    path.pop_back();
+                    game.revert(path.back().played);
+                    continue;
+                } else if (visit == Visit::FULL) {
+                    path.pop_back();
+                    return SearchOutcome::STOPPED;
+                }
+                expandFrame(game, path.back());
+            }
+            return SearchOutcome::EXHAUSTED;
+        }
+    }
+
+    Solver::Solver(SolverLimits limits): limits(limits), table(limits.tableBits) {}
+
+    SolveResult Solver::solve(const Game& start) {
+        using clock = std::chrono::steady_clock;
+        if (!start.getHeldCards().empty()) {
+            throw std::logic_error("Cannot solve a game while cards are being held.");
+        }
+
+        auto began = clock::now();
+        SolveResult result;
+        Game game = start;
+        this->table.clear();
+        this->table.insert(game.getHash());
+
+        SearchOutcome outcome = SearchOutcome::WON;
+        std::vector<Frame> path;
+        path.reserve(512);
+        if (!game.isWon()) {
+            auto probe = [this](std::uint64_t hash, std::vector<Frame>&) {
+                switch (this->table.insert(hash)) {
+                    case TranspositionTable::InsertResult::INSERTED: return Visit::NEW;
+                    case TranspositionTable::InsertResult::PRESENT: return Visit::SEEN;
+                    default: return Visit::FULL;
+                }
+            };
+            auto poll = [this, began](std::uint64_t nodes) {
+                if (this->limits.maxNodes != 0 && nodes >= this->limits.maxNodes) {
+                    return true;
+                }
+                if (nodes % 4096 != 0) {
+                    return false;
+                }
+                return this->cancelled.load(std::memory_order_relaxed)
+                    || (this->limits.maxTime.count() != 0 && clock::now() - began >= this->limits.maxTime);
+            };
+            outcome = depthFirst(game, path, result.nodes, probe, poll, [](std::vector<Frame>&) {});
+        }
+
+        if (outcome == SearchOutcome::WON) {
+            result.status = SolveStatus::SOLVED;
+            result.solution.reserve(path.size());
+            for (const Frame& frame : path) {
+                result.solution.push_back(frame.played.move);
+            }
+        } else if (outcome == SearchOutcome::STOPPED) {
+            result.status = SolveStatus::UNKNOWN;
+        } else {
+            result.status = SolveStatus::UNSOLVABLE;
+        }
+        result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - began);
+        return result;
+    }
+
+    void Solver::cancel() noexcept {
+        this->cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    void Solver::clearCancel() noexcept {
+        this->cancelled.store(false, std::memory_order_relaxed);
+    }
+
+    ParallelSolver::SharedTable::SharedTable(unsigned bits):
+        slots(new Slot[std::size_t(1) << bits]),
+        mask((std::size_t(1) << bits) - 1),
+        maxUsed((std::size_t(1) << bits) / 4 * 3),
+        usedSlots(new std::uint32_t[this->maxUsed])
+    {
+        for (std::size_t i = 0; i <= this->mask; i++) {
+            this->clearSlot(i);
+        }
+    }
+
+    template <typename Precedes>
+    ParallelSolver::SharedTable::Claim ParallelSolver::SharedTable::claim(
+        std::uint64_t hash,
+        std::uint32_t item,
+        std::uint32_t order,
+        Precedes&& precedes,
+        std::size_t& slot
+    ) noexcept {
+        if (hash == 0) hash = 1; // 0 marks empty slots
+        std::size_t i = static_cast<std::size_t>(hash) & this->mask;
+        while (true) {
+            Slot& entry = this->slots[i];
+            std::uint64_t stored = entry.hash.load(std::memory_order_acquire);
+            if (stored == 0) {
+                if (this->used.load(std::memory_order_relaxed) >= this->maxUsed) {
+                    return Claim::FULL;
+                }
+                // on failure stored becomes whatever another thread put in the slot
+                if (entry.hash.compare_exchange_strong(stored, hash, std::memory_order_acq_rel)) {
+                    std::size_t n = this->used.fetch_add(1, std::memory_order_relaxed);
+                    if (n < this->maxUsed) {
+                        this->usedSlots[n] = static_cast<std::uint32_t>(i);
+                    }
+                    stored = hash;
+                }
+            }
+
+            if (stored == hash) {
+                slot = i;
+                if (entry.state.load(std::memory_order_relaxed) == DEAD) {
+                    return Claim::DEAD;
+                }
+                std::uint32_t owner = entry.owner.load(std::memory_order_acquire);
+                while (owner == NO_OWNER || (owner != item && !precedes(owner, item))) {
+                    if (entry.owner.compare_exchange_weak(owner, item, std::memory_order_acq_rel)) {
+                        entry.order.store(order, std::memory_order_relaxed);
+                        entry.state.store(OPEN, std::memory_order_relaxed);
+                        return Claim::CLAIMED;
+                    }
+                }
+                return owner == item ? Claim::OWN : Claim::EARLIER;
+            }
+            i = (i + 1) & this->mask;
+        }
+    }
+
+    bool ParallelSolver::SharedTable::openOrder(std::size_t slot, std::uint32_t& order) const noexcept {
+        const Slot& entry = this->slots[slot];
+        if (entry.state.load(std::memory_order_relaxed) != OPEN) {
+            return false;
+        }
+        order = entry.order.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    void ParallelSolver::SharedTable::settle(std::size_t slot, bool dead) noexcept {
+        // a slot taken over by an earlier item may be settled by its old owner;
+        // that only ever makes the new owner more careful
+        this->slots[slot].state.store(dead ? DEAD : UNPROVEN, std::memory_order_relaxed);
+    }
+
+    void ParallelSolver::SharedTable::clearSlot(std::size_t i) noexcept {
+        this->slots[i].hash.store(0, std::memory_order_relaxed);
+        this->slots[i].owner.store(NO_OWNER, std::memory_order_relaxed);
+        this->slots[i].state.store(UNPROVEN, std::memory_order_relaxed);
+    }
+
+    void ParallelSolver::SharedTable::clear() noexcept {
+        std::size_t used = this->used.load(std::memory_order_relaxed);
+        if (used <= this->maxUsed) {
+            for (std::size_t n = 0; n < used; n++) {
+                this->clearSlot(this->usedSlots[n]);
+            }
+        } else {
+            for (std::size_t i = 0; i <= this->mask; i++) {
+                this->clearSlot(i);
+            }
+        }
+        this->used.store(0, std::memory_order_relaxed);
+    }
+
+    struct ParallelSolver::WorkItem {
+        std::vector<Move> line; // the moves leading from the start to the item's subtree
+        std::vector<std::uint8_t> rank; // which of its siblings each move of line was, in search order
+    };
+
+    struct ParallelSolver::WorkQueue {
+        std::mutex mutex;
+        std::deque<std::uint32_t> items;
+        std::atomic<std::size_t> size {0}; // items.size(), readable without the lock
+    };
+
+    struct ParallelSolver::Search {
+        static constexpr std::uint32_t CHUNK_BITS = 12;
+        static constexpr std::uint32_t CHUNK_SIZE = 1 << CHUNK_BITS;
+
+        const Game& start;
+        std::chrono::steady_clock::time_point began;
+        // allocated as needed and never moved, so items can be read while others are added;
+        // an item is only read after its number was handed over, which orders it after its chunk
+        std::array<std::unique_ptr<WorkItem[]>, MAX_WORK_ITEMS / CHUNK_SIZE> chunks;
+        std::uint32_t itemCount = 0;
+        std::mutex itemMutex; // guards itemCount and adding chunks
+        std::unique_ptr<WorkQueue[]> queues;
+        std::atomic<std::uint32_t> pending {0}; // items created but not yet finished
+        std::atomic<unsigned> idle {0}; // threads looking for work
+        std::atomic<std::uint64_t> nodes {0};
+        std::atomic<bool> stopped {false}; // out of budget, table full or cancelled
+
+        // idle threads sleep on this until there is work to steal or the search is over
+        std::mutex idleMutex;
+        std::condition_variable wake;
+
+        std::mutex bestMutex;
+        std::atomic<std::uint32_t> best {SharedTable::NO_OWNER}; // the earliest item that won
+        std::vector<Move> solution;
+
+        Search(const Game& start, unsigned threads):
+            start(start),
+            began(std::chrono::steady_clock::now()),
+            queues(new WorkQueue[threads]) {}
+
+        WorkItem& itemAt(std::uint32_t i) const noexcept {
+            return this->chunks[i >> CHUNK_BITS][i & (CHUNK_SIZE - 1)];
+        }
+
+        /**
+         * @brief Makes room for count new items.
+         * @param first Set to the number of the first of them.
+         * @return false if that would pass MAX_WORK_ITEMS; nothing is added then.
+         */
+        bool addItems(std::uint32_t count, std::uint32_t& first) {
+            std::lock_guard<std::mutex> lock(this->itemMutex);
+            if (count > MAX_WORK_ITEMS - this->itemCount) {
+                return false;
+            }
+            first = this->itemCount;
+            this->itemCount += count;
+            for (std::uint32_t chunk = first >> CHUNK_BITS; chunk <= (this->itemCount - 1) >> CHUNK_BITS; chunk++) {
+                if (!this->chunks[chunk]) {
+                    this->chunks[chunk].reset(new WorkItem[CHUNK_SIZE]);
+                }
+            }
+            return true;
+        }
+
+        /// @brief Checks if a depth-first search would reach item a before item b.
+        bool precedes(std::uint32_t a, std::uint32_t b) const noexcept {
+            const auto& first = this->itemAt(a).rank;
+            const auto& second = this->itemAt(b).rank;
+            return std::lexicographical_compare(first.begin(), first.end(), second.begin(), second.end());
+        }
+
+        /// @brief Checks if an earlier item than item has already won, making item pointless.
+        bool beaten(std::uint32_t item) const noexcept {
+            std::uint32_t winner = this->best.load(std::memory_order_acquire);
+            return winner != SharedTable::NO_OWNER && this->precedes(winner, item);
+        }
+
+        void win(std::uint32_t item, std::vector<Move>&& line) {
+            std::lock_guard<std::mutex> lock(this->bestMutex);
+            std::uint32_t winner = this->best.load(std::memory_order_relaxed);
+            if (winner == SharedTable::NO_OWNER || this->precedes(item, winner)) {
+                this->solution = std::move(line);
+                this->best.store(item, std::memory_order_release);
+            }
+        }
+
+        void push(unsigned worker, std::uint32_t item) {
+            WorkQueue& queue = this->queues[worker];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.items.push_back(item);
+            queue.size.store(queue.items.size(), std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Wakes the idle threads after work was queued or the search ended.
+         * Taking idleMutex first means a thread checking for work under it either sees
+         * the change or is already waiting when notified.
+         */
+        void wakeIdle() {
+            {
+                std::lock_guard<std::mutex> lock(this->idleMutex);
+            }
+            this->wake.notify_all();
+        }
+
+        void stop() {
+            this->stopped.store(true, std::memory_order_relaxed);
+            this->wakeIdle();
+        }
+
+        void finish() {
+            if (this->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                this->wakeIdle();
+            }
+        }
+
+        /// @brief Checks if an idle thread should stop waiting: there is work to steal, or no more will come.
+        bool idleCanLeave(unsigned threads) const noexcept {
+            if (this->stopped.load(std::memory_order_relaxed) || this->pending.load(std::memory_order_acquire) == 0) {
+                return true;
+            }
+            for (unsigned i = 0; i < threads; i++) {
+                if (this->queues[i].size.load(std::memory_order_relaxed) != 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool pop(unsigned worker, std::uint32_t& item) {
+            WorkQueue& queue = this->queues[worker];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.items.empty()) {
+                return false;
+            }
+            item = queue.items.front();
+            queue.items.pop_front();
+            queue.size.store(queue.items.size(), std::memory_order_relaxed);
+            return true;
+        }
+
+        bool steal(unsigned worker, unsigned threads, std::uint32_t& item) {
+            for (unsigned i = 1; i < threads; i++) {
+                WorkQueue& queue = this->queues[(worker + i) % threads];
+                if (queue.size.load(std::memory_order_relaxed) == 0) continue;
+
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (queue.items.empty()) continue;
+                item = queue.items.back();
+                queue.items.pop_back();
+                queue.size.store(queue.items.size(), std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief Gives away the untried moves of the shallowest frame that has any,
+         * as new items on worker's own queue, and drops them from path.
+         */
+        void donate(unsigned worker, std::uint32_t item, std::vector<Frame>& path) {
+            std::size_t depth = 0;
+            while (depth < path.size() && path[depth].next == path[depth].moves.size()) {
+                depth++;
+            }
+            if (depth == path.size()) {
+                return;
+            }
+
+            Frame& frame = path[depth];
+            std::uint32_t given = static_cast<std::uint32_t>(frame.moves.size() - frame.next);
+            std::uint32_t first;
+            if (!this->addItems(given, first)) {
+                return;
+            }
+
+            WorkItem base = this->itemAt(item);
+            for (std::size_t i = 0; i < depth; i++) {
+                base.line.push_back(path[i].moves[path[i].next - 1]);
+                base.rank.push_back(static_cast<std::uint8_t>(path[i].next - 1));
+            }
+            this->pending.fetch_add(given, std::memory_order_relaxed);
+            for (std::uint32_t i = 0; i < given; i++) {
+                WorkItem& donated = this->itemAt(first + i);
+                donated = base;
+                donated.line.push_back(frame.moves[frame.next + i]);
+                donated.rank.push_back(static_cast<std::uint8_t>(frame.next + i));
+                this->push(worker, first + i);
+            }
+            this->wakeIdle();
+            frame.moves.truncate(frame.next);
+            frame.unproven = true; // the donated moves are searched elsewhere
+        }
+    };
+
+    ParallelSolver::ParallelSolver(SolverLimits limits, unsigned threads):
+        limits(limits),
+        threads(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())),
+        table(limits.tableBits) {}
+
+    void ParallelSolver::work(Search& search, unsigned worker) {
+        using clock = std::chrono::steady_clock;
+        Game game = search.start;
+        std::vector<Frame> path;
+        path.reserve(512);
+        std::vector<std::size_t> open; // claimed positions not settled yet
+
+        while (!search.stopped.load(std::memory_order_relaxed)) {
+            std::uint32_t item;
+            if (!search.pop(worker, item)) {
+                search.idle.fetch_add(1, std::memory_order_relaxed);
+                bool found = false;
+                while (!search.stopped.load(std::memory_order_relaxed)
+                    && search.pending.load(std::memory_order_acquire) != 0
+                    && !(found = search.steal(worker, this->threads, item))
+                ) {
+                    std::unique_lock<std::mutex> lock(search.idleMutex);
+                    search.wake.wait(lock, [&] { return search.idleCanLeave(this->threads); });
+                }
+                search.idle.fetch_sub(1, std::memory_order_relaxed);
+                if (!found) {
+                    return;
+                }
+            }
+
+            if (!search.beaten(item)) {
+                game = search.start;
+                for (const Move& move : search.itemAt(item).line) {
+                    game.apply(move);
+                }
+
+                if (game.isWon()) {
+                    search.win(item, std::vector<Move>(search.itemAt(item).line));
+                } else {
+                    open.clear();
+                    bool full = false;
+                    std::uint64_t nodes = 0;
+                    std::uint64_t unflushed = 0;
+                    auto precedes = [&search](std::uint32_t a, std::uint32_t b) {
+                        return search.precedes(a, b);
+                    };
+                    std::uint32_t reached = 0;
+                    auto probe = [&](std::uint64_t hash, std::vector<Frame>& path) {
+                        Frame& child = path.back();
+                        Frame& parent = path[path.size() - 2];
+                        std::uint32_t order = 0;
+                        switch (this->table.claim(hash, item, reached + 1, precedes, child.slot)) {
+                            case SharedTable::Claim::CLAIMED:
+                                child.order = child.low = ++reached;
+                                open.push_back(child.slot);
+                                return Visit::NEW;
+                            case SharedTable::Claim::DEAD:
+                                return Visit::SEEN;
+                            case SharedTable::Claim::OWN:
+                                if (this->table.openOrder(child.slot, order)) {
+                                    parent.low = std::min(parent.low, order);
+                                } else {
+                                    parent.unproven = true;
+                                }
+                                return Visit::SEEN;
+                            case SharedTable::Claim::EARLIER:
+                                parent.unproven = true;
+                                return Visit::SEEN;
+                            case SharedTable::Claim::FULL:
+                                full = true;
+                                return Visit::FULL;
+                        }
+                        return Visit::FULL;
+                    };
+                    auto poll = [&](std::uint64_t) {
+                        if (++unflushed < 1024) {
+                            return false;
+                        }
+                        std::uint64_t total = search.nodes.fetch_add(unflushed, std::memory_order_relaxed) + unflushed;
+                        unflushed = 0;
+                        if ((this->limits.maxNodes != 0 && total >= this->limits.maxNodes)
+                            || (this->limits.maxTime.count() != 0 && clock::now() - search.began >= this->limits.maxTime)
+                            || this->cancelled.load(std::memory_order_relaxed)
+                        ) {
+                            search.stop();
+                        }
+                        if (search.stopped.load(std::memory_order_relaxed) || search.beaten(item)) {
+                            return true;
+                        }
+                        if (search.idle.load(std::memory_order_relaxed) != 0
+                            && search.queues[worker].size.load(std::memory_order_relaxed) == 0
+                        ) {
+                            search.donate(worker, item, path);
+                        }
+                        return false;
+                    };
+
+                    // Positions only settle once the earliest one they can lead back to is done,
+                    // as in Tarjan's strongly connected components algorithm.
+                    auto retire = [&](std::vector<Frame>& path) {
+                        const Frame& frame = path.back();
+                        if (frame.low == frame.order) {
+                            while (!open.empty()) {
+                                std::size_t slot = open.back();
+                                open.pop_back();
+                                this->table.settle(slot, !frame.unproven);
+                                if (slot == frame.slot) break;
+                            }
+                        }
+                        if (path.size() > 1) {
+                            Frame& parent = path[path.size() - 2];
+                            parent.low = std::min(parent.low, frame.low);
+                            parent.unproven = parent.unproven || frame.unproven;
+                        }
+                    };
+
+                    if (depthFirst(game, path, nodes, probe, poll, retire) == SearchOutcome::WON) {
+                        std::vector<Move> line = search.itemAt(item).line;
+                        for (const Frame& frame : path) {
+                            line.push_back(frame.played.move);
+                        }
+                        search.win(item, std::move(line));
+                    }
+                    if (full) {
+                        search.stop();
+                    }
+                    search.nodes.fetch_add(unflushed, std::memory_order_relaxed);
+                }
+            }
+            search.finish();
+        }
+    }
+
+    SolveResult ParallelSolver::solve(const Game& start) {
+        if (!start.getHeldCards().empty()) {
+            throw std::logic_error("Cannot solve a game while cards are being held.");
+        }
+
+        this->cancelled.store(false, std::memory_order_relaxed);
+        this->table.clear();
+        Search search(start, this->threads);
+        std::uint32_t root;
+        search.addItems(1, root);
+        search.pending.store(1, std::memory_order_relaxed);
+        search.push(0, root);
+
+        std::vector<std::thread> helpers;
+        helpers.reserve(this->threads - 1);
+        for (unsigned worker = 1; worker < this->threads; worker++) {
+            helpers.emplace_back(&ParallelSolver::work, this, std::ref(search), worker);
+        }
+        this->work(search, 0);
+        for (std::thread& helper : helpers) {
+            helper.join();
+        }
+
+        SolveResult result;
+        if (search.best.load(std::memory_order_relaxed) != SharedTable::NO_OWNER) {
+            result.status = SolveStatus::SOLVED;
+            result.solution = std::move(search.solution);
+        } else if (search.stopped.load(std::memory_order_relaxed)) {
+            result.status = SolveStatus::UNKNOWN;
+        } else {
+            result.status = SolveStatus::UNSOLVABLE;
+        }
+        result.nodes = search.nodes.load(std::memory_order_relaxed);
+        result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - search.began
+        );
+        return result;
+    }
+
+    void ParallelSolver::cancel() noexcept {
+        this->cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    unsigned ParallelSolver::threadCount() const noexcept {
+        return this->threads;
+    }
+}
@@ -0,0 +1,22 @@
+#include "zobrist.hpp"
+
+namespace solitaire::zobrist {
+    // splitmix64, so the keys are fixed at compile time and identical across builds.
+    constexpr std::uint64_t splitMix(std::uint64_t& state) noexcept {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    constexpr std::array<std::uint64_t, PILE_OFFSETS[PILE_COUNT]> makeKeys() noexcept {
+        std::array<std::uint64_t, PILE_OFFSETS[PILE_COUNT]> keys {};
+        std::uint64_t state = 0x5EED5017A1BEull;
+        for (auto& k : keys) {
+            k = splitMix(state);
+        }
+        return keys;
+    }
+
+    const std::array<std::uint64_t, PILE_OFFSETS[PILE_COUNT]> KEYS = makeKeys();
+}
@@ -0,0 +1,248 @@
+/**
+ * @file cardpile.cpp
+ * @brief Checks the bulk CardPile moves against a std::vector model, and replays
+ * random calls of the whole public Game API, which is built on them.
+ *
+ * The replay tries every kind of pick-up and placement, legal or not, and checks
+ * after each call that no card was lost or duplicated, that cards keep or reverse
+ * their order as the move demands, and that calls which fail leave the game untouched.
+ */
+
+#include "check.hpp"
+
+#include <vector>
+
+using namespace solitaire;
+
+namespace {
+    using Model = std::vector<Card>; // base first, like the storage of a CardPile
+
+    Model cardsOf(const CardPile& pile) {
+        return Model(pile.rbegin(), pile.rend());
+    }
+
+    /// @brief The top amount cards of a pile, base first.
+    Model topOf(const CardPile& pile, std::size_t amount) {
+        Model cards = cardsOf(pile);
+        return Model(cards.end() - amount, cards.end());
+    }
+
+    void checkPiles(std::minstd_rand& pick) {
+        std::array<CardPile, 3> piles;
+        std::array<Model, 3> models;
+        for (std::size_t i = 0; i < Card::DECK_SIZE; i++) {
+            Card card = Card::fromIndex(i);
+            piles[i % 3].add(card);
+            models[i % 3].push_back(card);
+        }
+
+        for (std::size_t step = 0; step < 200000; step++) {
+            std::size_t from = pick() % 3;
+            std::size_t to = (from + 1 + pick() % 2) % 3;
+            std::size_t amount = pick() % (models[from].size() + 2); // sometimes one too many
+            bool enough = amount <= models[from].size();
+            int operation = pick() % 5;
+            bool threw = false;
+            try {
+                switch (operation) {
+                    case 0:
+                        piles[from].moveTopOnto(piles[to], amount);
+                        break;
+                    case 1:
+                        piles[from].turnTopOnto(piles[to], amount);
+                        break;
+                    case 2:
+                        piles[to].stack(piles[from]);
+                        break;
+                    case 3:
+                        piles[from].turnOnto(piles[to]);
+                        break;
+                    case 4:
+                        piles[to].add(pick() % 2 ? piles[from].takeTop() : piles[from].takeBase());
+                        break;
+                }
+            } catch (const NotEnoughCardsException&) {
+                threw = true;
+            }
+
+            Model& source = models[from];
+            Model& dest = models[to];
+            switch (operation) {
+                case 0:
+                    CHECK_THAT(threw == !enough, "moveTopOnto of " << amount << " from " << source.size());
+                    if (enough) {
+                        dest.insert(dest.end(), source.end() - amount, source.end());
+                        source.resize(source.size() - amount);
+                    }
+                    break;
+                case 1:
+                    CHECK_THAT(threw == !enough, "turnTopOnto of " << amount << " from " << source.size());
+                    if (enough) {
+                        dest.insert(dest.end(), source.rbegin(), source.rbegin() + amount);
+                        source.resize(source.size() - amount);
+                    }
+                    break;
+                case 2:
+                    dest.insert(dest.end(), source.begin(), source.end());
+                    source.clear();
+                    break;
+                case 3:
+                    dest.insert(dest.end(), source.rbegin(), source.rend());
+                    source.clear();
+                    break;
+                case 4:
+                    CHECK_THAT(threw == source.empty(), "taking from a pile of " << source.size());
+                    break;
+            }
+            if (operation == 4) {
+                models[from] = cardsOf(piles[from]);
+                models[to] = cardsOf(piles[to]);
+            }
+            for (std::size_t i = 0; i < 3; i++) {
+                CHECK_THAT(cardsOf(piles[i]) == models[i], "pile " << i << " after operation " << operation);
+            }
+        }
+        CHECK(piles[0].size() + piles[1].size() + piles[2].size() == Card::DECK_SIZE);
+    }
+
+    /// @brief Checks that the cards on the board (and held) are a whole deck, each card once.
+    void checkDeck(const Game& game, const std::string& after) {
+        std::uint64_t seen = 0;
+        std::size_t count = 0;
+        auto see = [&](const CardPile& pile) {
+            for (Card card : pile) {
+                CHECK_THAT((seen & (std::uint64_t(1) << card.index())) == 0, card << " twice after " << after);
+                seen |= std::uint64_t(1) << card.index();
+                count++;
+            }
+        };
+        see(game.getStock());
+        see(game.getWaste());
+        see(game.getHeldCards());
+        for (std::size_t i = 0; i < NUM_TABLEAUS; i++) {
+            see(game.getOpenTableau(i));
+            count += game.getClosedTableauSize(i);
+        }
+        for (Suit s = Suit::FIRST; s < Suit::END; s++) {
+            const Card *top = game.peekFoundation(s);
+            std::size_t size = top == nullptr ? 0 : static_cast<std::size_t>(top->face()); // the faces start at 1
+            count += size;
+        }
+        CHECK_THAT(count == Card::DECK_SIZE, count << " cards after " << after << ": " << check::describe(game));
+    }
+
+    /// @brief Drops the held cards somewhere, the way the player might, and checks where they land.
+    void dropHeld(Game& game, std::minstd_rand& pick) {
+        Model held = cardsOf(game.getHeldCards());
+        std::string before = check::describe(game);
+        int choice = pick() % 5;
+        std::size_t tableau = pick() % NUM_TABLEAUS;
+        Suit suit = static_cast<Suit>(pick() % 4);
+        MoveRecord record {};
+        PlacementResult result = PlacementResult::OK;
+        try {
+            switch (choice) {
+                case 0:
+                    game.returnHeldCards();
+                    break;
+                case 1:
+                    result = game.tryStackTableau(tableau, &record);
+                    break;
+                case 2:
+                    result = game.tryStackFoundation(suit, &record);
+                    break;
+                case 3:
+                    record = game.stackTableau(tableau);
+                    break;
+                case 4:
+                    record = pick() % 2 ? game.attemptHeldToTableau() : game.attemptHeldToFoundation();
+                    break;
+            }
+        } catch (const std::exception&) {
+            result = PlacementResult::NO_SUCH_PILE; // any failure
+        }
+
+        bool dropped = game.getHeldCards().empty();
+        if (choice != 4) {
+            CHECK_THAT(dropped == (result == PlacementResult::OK), "drop " << choice << " gave " << placementResultToString(result));
+        }
+        if (!dropped) {
+            CHECK_THAT(check::describe(game) == before, "a failed drop changed the game");
+            CHECK_THAT(cardsOf(game.getHeldCards()) == held, "a failed drop changed the held cards");
+            game.returnHeldCards();
+        }
+        if (!record.empty() && record.move.type != MoveType::WASTE_TO_FOUNDATION
+            && record.move.type != MoveType::TABLEAU_TO_FOUNDATION
+        ) {
+            CHECK_THAT(topOf(game.getOpenTableau(record.move.to), held.size()) == held, "cards reordered by " << record.move);
+        }
+    }
+
+    void replayGame(std::minstd_rand::result_type seed, config::wasteDifficulty draw, std::minstd_rand& pick) {
+        Game *game = Game::createFromSeed(seed, draw);
+        for (std::size_t step = 0; step < 400; step++) {
+            std::size_t tableau = pick() % NUM_TABLEAUS;
+            switch (pick() % 6) {
+                case 0:
+                    if (game->hasStock()) {
+                        std::size_t amount = std::min(game->getDrawCount(), game->getStock().size());
+                        Model turned = topOf(game->getStock(), amount);
+                        game->turnStock();
+                        CHECK_THAT(topOf(game->getWaste(), amount) == Model(turned.rbegin(), turned.rend()), "seed " << seed << " turning the stock");
+                    } else {
+                        Model waste = cardsOf(game->getWaste());
+                        game->returnWasteToStock();
+                        CHECK_THAT(cardsOf(game->getStock()) == Model(waste.rbegin(), waste.rend()), "seed " << seed << " recycling the waste");
+                    }
+                    break;
+                case 1:
+                    if (game->hasWaste()) {
+                        game->takeWaste();
+                        dropHeld(*game, pick);
+                    }
+                    break;
+                case 2: {
+                    Suit suit = static_cast<Suit>(pick() % 4);
+                    if (game->hasFoundation(suit)) {
+                        game->takeFoundation(suit);
+                        dropHeld(*game, pick);
+                    }
+                    break;
+                }
+                case 3:
+                case 4: {
+                    std::size_t open = game->getOpenTableau(tableau).size();
+                    if (open > 0) {
+                        std::size_t amount = 1 + pick() % open;
+                        Model taken = topOf(game->getOpenTableau(tableau), amount);
+                        game->takeTableau(tableau, amount);
+                        CHECK_THAT(cardsOf(game->getHeldCards()) == taken, "seed " << seed << " taking " << amount << " cards");
+                        dropHeld(*game, pick);
+                    }
+                    break;
+                }
+                case 5: {
+                    std::string before = check::describe(*game);
+                    try {
+                        game->turnClosedTableauTop(tableau);
+                    } catch (const std::exception&) {
+                        CHECK_THAT(check::describe(*game) == before, "seed " << seed << " a failed flip changed the game");
+                    }
+                    break;
+                }
+            }
+            checkDeck(*game, "seed " + std::to_string(seed) + " step " + std::to_string(step));
+        }
+        delete game;
+    }
+}
+
+int main() {
+    std::minstd_rand pick(3);
+    checkPiles(pick);
+    for (std::minstd_rand::result_type seed = 0; seed < 500; seed++) {
+        replayGame(seed, config::wasteDifficulty::ONE, pick);
+        replayGame(seed, config::wasteDifficulty::THREE, pick);
+    }
+    return check::finish("cardpile");
+}
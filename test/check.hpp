@@ -0,0 +1,122 @@
+#pragma once
+
+/**
+ * @file check.hpp
+ * @brief The few helpers the engine checks in this directory share.
+ *
+ * Each check is a program of its own, built against the engine library and run by
+ * `make check`. It prints every failed CHECK with its location and exits with a
+ * non-zero status if there was any.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "slt.hpp"
+
+namespace check {
+    inline int failures = 0;
+
+    /// @brief Records a failed check; gives up after too many, as the rest are likely the same failure.
+    inline void fail(const char *file, int line, const char *expression, const std::string& context) {
+        std::cerr << file << ":" << line << ": CHECK(" << expression << ") failed";
+        if (!context.empty()) {
+            std::cerr << ": " << context;
+        }
+        std::cerr << "\n";
+        if (++failures >= 20) {
+            std::cerr << "Too many failures, giving up.\n";
+            std::exit(1);
+        }
+    }
+
+    /// @brief Reports the outcome of the check named name.
+    /// @return The exit status of the check.
+    inline int finish(const char *name) {
+        if (failures == 0) {
+            std::cout << name << ": ok\n";
+            return 0;
+        }
+        std::cout << name << ": " << failures << " failure(s)\n";
+        return 1;
+    }
+
+    /**
+     * @brief Plays a move the way the game's UI does, through the held cards.
+     * The move must be legal, as listed by Game::generateMoves.
+     * @return The record of the move.
+     */
+    inline solitaire::MoveRecord playWithHeldCards(solitaire::Game& game, const solitaire::Move& move) {
+        using solitaire::MoveType;
+        using solitaire::Suit;
+        switch (move.type) {
+            case MoveType::TURN_STOCK:
+                return game.turnStock();
+            case MoveType::RECYCLE_WASTE:
+                return game.returnWasteToStock();
+            case MoveType::WASTE_TO_TABLEAU:
+                game.takeWaste();
+                return game.stackTableau(move.to);
+            case MoveType::WASTE_TO_FOUNDATION:
+                game.takeWaste();
+                return game.stackFoundation(static_cast<Suit>(move.to));
+            case MoveType::TABLEAU_TO_TABLEAU:
+                game.takeTableau(move.from, move.count);
+                return game.stackTableau(move.to);
+            case MoveType::TABLEAU_TO_FOUNDATION:
+                game.takeTableau(move.from, 1);
+                return game.stackFoundation(static_cast<Suit>(move.to));
+            case MoveType::FOUNDATION_TO_TABLEAU:
+                game.takeFoundation(static_cast<Suit>(move.from));
+                return game.stackTableau(move.to);
+            case MoveType::TURN_CLOSED_TABLEAU:
+                return game.turnClosedTableauTop(move.from);
+        }
+        return {};
+    }
+
+    /// @brief Writes every pile of a game, to compare positions and show them on failure.
+    inline std::string describe(const solitaire::Game& game) {
+        using namespace solitaire;
+        std::ostringstream out;
+        out << "moves " << game.getMoveCount() << ", stock";
+        for (Card card : game.getStock()) {
+            out << " " << card;
+        }
+        out << ", waste";
+        for (Card card : game.getWaste()) {
+            out << " " << card;
+        }
+        out << ", foundations";
+        for (Suit s = Suit::FIRST; s < Suit::END; s++) {
+            const Card *top = game.peekFoundation(s);
+            out << " ";
+            if (top != nullptr) {
+                out << *top;
+            } else {
+                out << "-";
+            }
+        }
+        for (std::size_t i = 0; i < NUM_TABLEAUS; i++) {
+            out << ", tableau " << i << ": " << game.getClosedTableauSize(i) << " closed";
+            for (Card card : game.getOpenTableau(i)) {
+                out << " " << card;
+            }
+        }
+        return out.str();
+    }
+}
+
+#define CHECK_THAT(expression, context) \
+    do { \
+        if (!(expression)) { \
+            std::ostringstream checkContext; \
+            checkContext << context; \
+            check::fail(__FILE__, __LINE__, #expression, checkContext.str()); \
+        } \
+    } while (false)
+
+#define CHECK(expression) CHECK_THAT(expression, "")
@@ -0,0 +1,59 @@
+/**
+ * @file hash.cpp
+ * @brief Checks that the incremental Zobrist hash always matches a full recompute.
+ *
+ * Random games are played both through apply() and through the held cards, then every
+ * move is undone and redone, comparing getHash() with computeHash() and with the hash
+ * the position had when it was first reached.
+ */
+
+#include "check.hpp"
+#include "journal.hpp"
+
+#include <vector>
+
+using namespace solitaire;
+
+namespace {
+    constexpr std::minstd_rand::result_type SEEDS = 1000;
+    constexpr std::size_t MOVES_PER_GAME = 300;
+
+    void checkGame(std::minstd_rand::result_type seed, config::wasteDifficulty draw, std::minstd_rand& pick) {
+        Game *game = Game::createFromSeed(seed, draw);
+        CHECK_THAT(game->getHash() == game->computeHash(), "seed " << seed << " as dealt");
+
+        MoveJournal journal;
+        std::vector<std::uint64_t> hashes {game->getHash()};
+        for (std::size_t i = 0; i < MOVES_PER_GAME; i++) {
+            MoveBuffer moves;
+            game->generateMoves(moves);
+            if (moves.empty()) break;
+
+            Move move = moves[pick() % moves.size()];
+            MoveRecord record = pick() % 2 ? game->apply(move) : check::playWithHeldCards(*game, move);
+            journal.record(record);
+            hashes.push_back(game->getHash());
+            CHECK_THAT(game->getHash() == game->computeHash(), "seed " << seed << " after " << move);
+        }
+
+        for (std::size_t i = hashes.size() - 1; i > 0; i--) {
+            journal.undo(*game);
+            CHECK_THAT(game->getHash() == game->computeHash(), "seed " << seed << " undoing move " << i);
+            CHECK_THAT(game->getHash() == hashes[i - 1], "seed " << seed << " undoing move " << i);
+        }
+        for (std::size_t i = 1; i < hashes.size(); i++) {
+            journal.redo(*game);
+            CHECK_THAT(game->getHash() == hashes[i], "seed " << seed << " redoing move " << i);
+        }
+        delete game;
+    }
+}
+
+int main() {
+    std::minstd_rand pick(7);
+    for (std::minstd_rand::result_type seed = 0; seed < SEEDS; seed++) {
+        checkGame(seed, config::wasteDifficulty::ONE, pick);
+        checkGame(seed, config::wasteDifficulty::THREE, pick);
+    }
+    return check::finish("hash");
+}
@@ -0,0 +1,122 @@
+/**
+ * @file hintengine.cpp
+ * @brief Checks that hints belong to the latest position handed over, that cancelling
+ * stops a search even before it starts, that won positions are reported as won, and
+ * that a hint found without a winning line turns the stock as far as the search would.
+ */
+
+#include "check.hpp"
+#include "hintengine.hpp"
+
+#include <memory>
+#include <thread>
+
+using namespace solitaire;
+
+namespace {
+    HintStatus waitForHint(const HintEngine& hints, Move& move) {
+        HintStatus status;
+        while ((status = hints.latest(move)) == HintStatus::PENDING) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return status;
+    }
+
+    bool isLegal(const Game& game, const Move& move) {
+        MoveBuffer moves;
+        game.generateMoves(moves);
+        game.generateStockJumps(moves);
+        for (const Move& legal : moves) {
+            if (legal == move) return true;
+        }
+        return false;
+    }
+
+    void checkCancelBeforeSolve() {
+        std::unique_ptr<Game> game(Game::createFromSeed(26));
+        SolverLimits limits;
+        limits.maxTime = std::chrono::milliseconds(0);
+        Solver solver(limits);
+        solver.cancel();
+        SolveResult result = solver.solve(*game);
+        CHECK_THAT(result.status == SolveStatus::UNKNOWN, "a cancelled solver " << solveStatusToString(result.status));
+        CHECK_THAT(result.nodes <= 4096, "a cancelled solver searched " << result.nodes << " nodes");
+
+        solver.clearCancel();
+        CHECK(solver.solve(*game).status == SolveStatus::SOLVED);
+    }
+
+    void checkWon() {
+        std::unique_ptr<Game> game(Game::createFromSeed(8));
+        SolveResult result = Solver().solve(*game);
+        CHECK(result.status == SolveStatus::SOLVED);
+        for (const Move& move : result.solution) {
+            game->apply(move);
+        }
+        CHECK(game->isWon());
+
+        HintEngine hints(std::chrono::milliseconds(100));
+        hints.submit(*game);
+        Move move;
+        CHECK(waitForHint(hints, move) == HintStatus::WON);
+    }
+
+    bool canPlayWaste(const Game& game) {
+        MoveBuffer moves;
+        game.generateMoves(moves);
+        for (const Move& move : moves) {
+            if (move.type == MoveType::WASTE_TO_TABLEAU || move.type == MoveType::WASTE_TO_FOUNDATION) return true;
+        }
+        return false;
+    }
+
+    void checkStockJump() {
+        // the deal of seed 4 can only turn the stock, its first card cannot be played, and
+        // the solver settles nothing in millions of nodes, so the hint can only be promising
+        std::unique_ptr<Game> game(Game::createFromSeed(4));
+        MoveBuffer moves;
+        game->generateMoves(moves);
+        CHECK(moves.size() == 1 && moves[0].type == MoveType::TURN_STOCK);
+        Game turned = *game;
+        turned.apply(moves[0]);
+        CHECK(!canPlayWaste(turned));
+
+        HintEngine hints(std::chrono::milliseconds(1));
+        hints.submit(*game);
+        Move move;
+        HintStatus status = waitForHint(hints, move);
+        CHECK_THAT(status == HintStatus::PROMISING, "seed 4 gave hint status " << static_cast<int>(status));
+        if (status == HintStatus::PROMISING) {
+            CHECK_THAT(move.type == MoveType::TURN_STOCK && isLegal(*game, move), "seed 4 hinted " << move);
+            game->apply(move);
+            CHECK_THAT(canPlayWaste(*game), "seed 4 hinted " << move << " which leaves nothing to play");
+        }
+    }
+
+    void checkLatestOnly() {
+        HintEngine hints(std::chrono::milliseconds(100));
+        for (std::minstd_rand::result_type seed = 0; seed < 20; seed++) {
+            std::unique_ptr<Game> game(Game::createFromSeed(seed));
+            hints.submit(*game);
+            // the board changes at once: only hints for the new position may show
+            MoveBuffer moves;
+            game->generateMoves(moves);
+            game->apply(moves[0]);
+            hints.submit(*game);
+
+            Move move;
+            HintStatus status = waitForHint(hints, move);
+            if (status == HintStatus::WINNING || status == HintStatus::PROMISING) {
+                CHECK_THAT(isLegal(*game, move), "seed " << seed << " hinted " << move << " in " << check::describe(*game));
+            }
+        }
+    }
+}
+
+int main() {
+    checkCancelBeforeSolve();
+    checkWon();
+    checkStockJump();
+    checkLatestOnly();
+    return check::finish("hintengine");
+}
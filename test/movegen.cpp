@@ -0,0 +1,118 @@
+/**
+ * @file movegen.cpp
+ * @brief Checks Game::generateMoves against a brute-force search through the held cards.
+ *
+ * In positions from random games, every pick-up the game allows is tried onto every pile,
+ * on a copy of the game, and the moves whose placement succeeds must be exactly the ones
+ * generated, tableau run lengths included.
+ */
+
+#include "check.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace solitaire;
+
+namespace {
+    constexpr std::minstd_rand::result_type SEEDS = 1000;
+    constexpr std::size_t MOVES_PER_GAME = 200;
+
+    std::uint32_t key(const Move& move) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &move, sizeof(bits));
+        return bits;
+    }
+
+    bool byKey(const Move& a, const Move& b) {
+        return key(a) < key(b);
+    }
+
+    /// @brief Tries to drop the held cards of copy on every tableau and foundation, keeping the moves that work.
+    void dropEverywhere(const Game& copy, std::vector<Move>& found) {
+        for (std::size_t to = 0; to < NUM_TABLEAUS; to++) {
+            Game g = copy;
+            MoveRecord record {};
+            if (g.tryStackTableau(to, &record) == PlacementResult::OK && !record.empty()) {
+                found.push_back(record.move);
+            }
+        }
+        for (Suit s = Suit::FIRST; s < Suit::END; s++) {
+            Game g = copy;
+            MoveRecord record {};
+            if (g.tryStackFoundation(s, &record) == PlacementResult::OK && !record.empty()) {
+                found.push_back(record.move);
+            }
+        }
+    }
+
+    std::vector<Move> bruteForce(const Game& game) {
+        std::vector<Move> found;
+        if (game.hasStock()) {
+            Game g = game;
+            found.push_back(g.turnStock().move);
+        } else if (game.hasWaste()) {
+            Game g = game;
+            found.push_back(g.returnWasteToStock().move);
+        }
+        if (game.hasWaste()) {
+            Game g = game;
+            g.takeWaste();
+            dropEverywhere(g, found);
+        }
+        for (Suit s = Suit::FIRST; s < Suit::END; s++) {
+            if (game.hasFoundation(s)) {
+                Game g = game;
+                g.takeFoundation(s);
+                dropEverywhere(g, found);
+            }
+        }
+        for (std::size_t from = 0; from < NUM_TABLEAUS; from++) {
+            std::size_t open = game.getOpenTableau(from).size();
+            if (open == 0 && game.getClosedTableauSize(from) > 0) {
+                Game g = game;
+                found.push_back(g.turnClosedTableauTop(from).move);
+            }
+            for (std::size_t amount = 1; amount <= open; amount++) {
+                Game g = game;
+                g.takeTableau(from, amount);
+                dropEverywhere(g, found);
+            }
+        }
+        std::sort(found.begin(), found.end(), byKey);
+        return found;
+    }
+
+    void checkGame(std::minstd_rand::result_type seed, config::wasteDifficulty draw, std::minstd_rand& pick) {
+        Game *game = Game::createFromSeed(seed, draw);
+        for (std::size_t i = 0; i < MOVES_PER_GAME; i++) {
+            MoveBuffer buffer;
+            game->generateMoves(buffer);
+            std::vector<Move> generated(buffer.begin(), buffer.end());
+            std::sort(generated.begin(), generated.end(), byKey);
+            std::vector<Move> expected = bruteForce(*game);
+            if (generated != expected) {
+                std::ostringstream moves;
+                moves << "generated";
+                for (const Move& move : generated) moves << " " << move;
+                moves << "; expected";
+                for (const Move& move : expected) moves << " " << move;
+                CHECK_THAT(generated == expected, "seed " << seed << ", " << check::describe(*game) << "\n  " << moves.str());
+            }
+            if (buffer.empty()) break;
+
+            game->apply(buffer[pick() % buffer.size()]);
+        }
+        delete game;
+    }
+}
+
+int main() {
+    std::minstd_rand pick(5);
+    for (std::minstd_rand::result_type seed = 0; seed < SEEDS; seed++) {
+        checkGame(seed, config::wasteDifficulty::ONE, pick);
+        checkGame(seed, config::wasteDifficulty::THREE, pick);
+    }
+    return check::finish("movegen");
+}
@@ -0,0 +1,162 @@
+/**
+ * @file savegame.cpp
+ * @brief Checks that saved games round-trip, and that load() rejects corrupt saves
+ * without touching the game.
+ */
+
+#include "check.hpp"
+
+using namespace solitaire;
+
+namespace {
+    // the bit offsets of the save layout documented at Game::save, from the start of the data
+    constexpr std::size_t DRAW_BIT = 8;
+    constexpr std::size_t FOUNDATION_SIZES_BIT = DRAW_BIT + 1 + 24;
+    constexpr std::size_t STOCK_SIZE_BIT = FOUNDATION_SIZES_BIT + 4 * 4;
+    constexpr std::size_t CARDS_BIT = STOCK_SIZE_BIT + 2 * 6 + NUM_TABLEAUS * (3 + 4);
+
+    std::uint32_t getBits(const Game::SaveData& data, std::size_t at, unsigned bits) {
+        std::uint32_t value = 0;
+        for (unsigned i = 0; i < bits; i++) {
+            value |= std::uint32_t((data[(at + i) / 8] >> ((at + i) % 8)) & 1) << i;
+        }
+        return value;
+    }
+
+    void setBits(Game::SaveData& data, std::size_t at, unsigned bits, std::uint32_t value) {
+        for (unsigned i = 0; i < bits; i++) {
+            std::uint8_t mask = std::uint8_t(1 << ((at + i) % 8));
+            data[(at + i) / 8] = (value >> i) & 1 ? data[(at + i) / 8] | mask : data[(at + i) / 8] & ~mask;
+        }
+    }
+
+    std::size_t cardBit(std::size_t i) {
+        return CARDS_BIT + 6 * i;
+    }
+
+    bool samePosition(const Game& a, const Game& b) {
+        return check::describe(a) == check::describe(b)
+            && a.getHash() == b.getHash()
+            && a.getDrawCount() == b.getDrawCount()
+            && a.getReachableThisPass() == b.getReachableThisPass()
+            && a.getReachableLaterPasses() == b.getReachableLaterPasses();
+    }
+
+    /// @brief Checks that load() refuses data and leaves the game as it was.
+    void checkRejected(const Game::SaveData& data, const char *corruption, std::minstd_rand::result_type seed) {
+        Game *game = Game::createFromSeed(seed + 1);
+        Game before = *game;
+        CHECK_THAT(!game->load(data), "seed " << seed << " loaded a save with " << corruption);
+        CHECK_THAT(samePosition(*game, before), "seed " << seed << " a save with " << corruption << " changed the game");
+        delete game;
+
+        bool threw = false;
+        try {
+            delete Game::createFromSave(data);
+        } catch (const InvalidSaveException&) {
+            threw = true;
+        }
+        CHECK_THAT(threw, "seed " << seed << " createFromSave took a save with " << corruption);
+    }
+
+    void checkCorruptions(const Game& game, const Game::SaveData& data, std::minstd_rand::result_type seed) {
+        Game::SaveData bad = data;
+        bad[0] = Game::SAVE_VERSION + 1;
+        checkRejected(bad, "a bad version byte", seed);
+
+        std::size_t stockSize = game.getStock().size();
+        std::size_t wasteSize = game.getWaste().size();
+        std::size_t closedSize = 0;
+        for (std::size_t i = 0; i < NUM_TABLEAUS; i++) {
+            closedSize += game.getClosedTableauSize(i);
+        }
+        std::size_t stored = stockSize + wasteSize + closedSize;
+        for (std::size_t i = 0; i < NUM_TABLEAUS; i++) {
+            stored += game.getOpenTableau(i).size();
+        }
+
+        // make sure the corruptions below hit the fields they mean to
+        CHECK(getBits(data, DRAW_BIT, 1) == (game.getDrawCount() == 3 ? 1u : 0u));
+        CHECK(getBits(data, STOCK_SIZE_BIT, 6) == stockSize);
+        if (stockSize > 0) {
+            CHECK(getBits(data, cardBit(0), 6) == game.getStock().peekBase()->index());
+        }
+
+        if (stored >= 2) {
+            bad = data;
+            setBits(bad, cardBit(1), 6, getBits(bad, cardBit(0), 6));
+            checkRejected(bad, "a duplicate card", seed);
+        }
+        if (stored >= 1) {
+            bad = data;
+            setBits(bad, cardBit(0), 6, Card::DECK_SIZE);
+            checkRejected(bad, "a card index out of range", seed);
+        }
+
+        bad = data;
+        setBits(bad, STOCK_SIZE_BIT, 6, stockSize + 1);
+        checkRejected(bad, "one card too many", seed);
+
+        bad = data;
+        setBits(bad, FOUNDATION_SIZES_BIT, 4, 14);
+        checkRejected(bad, "an overfull foundation", seed);
+
+        // swapping the base of a run of open cards with the card on it breaks the tableau rules
+        std::size_t openStart = stockSize + wasteSize + closedSize;
+        for (std::size_t i = 0; i < NUM_TABLEAUS; i++) {
+            std::size_t size = game.getOpenTableau(i).size();
+            if (size >= 2) {
+                bad = data;
+                std::uint32_t base = getBits(bad, cardBit(openStart), 6);
+                setBits(bad, cardBit(openStart), 6, getBits(bad, cardBit(openStart + 1), 6));
+                setBits(bad, cardBit(openStart + 1), 6, base);
+                checkRejected(bad, "a broken tableau run", seed);
+                break;
+            }
+            openStart += size;
+        }
+    }
+
+    void checkGame(std::minstd_rand::result_type seed, config::wasteDifficulty draw, std::minstd_rand& pick) {
+        Game *game = Game::createFromSeed(seed, draw);
+        Game::SaveData data;
+        for (std::size_t i = 0; i < 150; i++) {
+            game->save(data);
+            Game *loaded = Game::createFromSave(data);
+            CHECK_THAT(samePosition(*game, *loaded), "seed " << seed << " move " << i
+                << "\n  saved  " << check::describe(*game) << "\n  loaded " << check::describe(*loaded));
+            CHECK(loaded->getMoveCount() == game->getMoveCount());
+            delete loaded;
+            if (i % 30 == 0) {
+                checkCorruptions(*game, data, seed);
+            }
+
+            MoveBuffer moves;
+            game->generateMoves(moves);
+            if (moves.empty()) break;
+            game->apply(moves[pick() % moves.size()]);
+        }
+
+        if (game->hasWaste()) {
+            game->takeWaste();
+            bool threw = false;
+            try {
+                game->save(data);
+            } catch (const std::logic_error&) {
+                threw = true;
+            }
+            CHECK_THAT(threw, "seed " << seed << " saved while holding cards");
+            game->returnHeldCards();
+        }
+        delete game;
+    }
+}
+
+int main() {
+    std::minstd_rand pick(11);
+    for (std::minstd_rand::result_type seed = 0; seed < 300; seed++) {
+        checkGame(seed, config::wasteDifficulty::ONE, pick);
+        checkGame(seed, config::wasteDifficulty::THREE, pick);
+    }
+    return check::finish("savegame");
+}
@@ -0,0 +1,105 @@
+/**
+ * @file solver.cpp
+ * @brief Checks the solver's verdicts: the solutions it finds must replay to a won game,
+ * deals known to be winnable must not be called unsolvable, and the parallel solver
+ * must reach the same verdicts and lines as Solver at any thread count, every time.
+ */
+
+#include "check.hpp"
+#include "solver.hpp"
+
+using namespace solitaire;
+
+namespace {
+    SolverLimits limits() {
+        SolverLimits limits;
+        limits.maxNodes = 200'000;
+        limits.maxTime = std::chrono::milliseconds(0);
+        limits.tableBits = 20;
+        return limits;
+    }
+
+    /**
+     * @brief Checks if a search ran to its end rather than being stopped by its node budget.
+     * A parallel search stopped after some item won still returns that line, but an earlier
+     * item may have been cut short, so the line is not necessarily the one Solver finds.
+     */
+    bool finished(const SolveResult& result) {
+        return result.status != SolveStatus::UNKNOWN && result.nodes < limits().maxNodes;
+    }
+
+    /// @brief Plays a solution on the deal of seed, checking each move is legal, and checks it wins.
+    void checkSolution(std::minstd_rand::result_type seed, config::wasteDifficulty draw, const SolveResult& result) {
+        Game *game = Game::createFromSeed(seed, draw);
+        for (const Move& move : result.solution) {
+            MoveBuffer moves;
+            game->generateMoves(moves);
+            game->generateStockJumps(moves); // the solver turns the stock by these
+            bool legal = false;
+            for (const Move& candidate : moves) {
+                legal = legal || candidate == move;
+            }
+            CHECK_THAT(legal, "seed " << seed << " solution plays illegal " << move);
+            if (!legal) break;
+            game->apply(move);
+        }
+        CHECK_THAT(game->isWon(), "seed " << seed << " solution does not win");
+        delete game;
+    }
+
+    void checkSeed(Solver& solver, std::minstd_rand::result_type seed, config::wasteDifficulty draw, SolveStatus expected) {
+        Game *game = Game::createFromSeed(seed, draw);
+        SolveResult result = solver.solve(*game);
+        delete game;
+        CHECK_THAT(result.status == expected, "seed " << seed << " drawing " << (draw == config::wasteDifficulty::THREE ? 3 : 1)
+            << " is " << solveStatusToString(result.status) << ", not " << solveStatusToString(expected));
+        if (result.status == SolveStatus::SOLVED) {
+            checkSolution(seed, draw, result);
+        }
+    }
+}
+
+int main() {
+    Solver solver(limits());
+
+    // drawing three, playing the waste top to a foundation regroups the stock,
+    // so it cannot be forced the way it is when drawing one
+    checkSeed(solver, 255, config::wasteDifficulty::THREE, SolveStatus::SOLVED);
+
+    for (std::minstd_rand::result_type seed = 0; seed < 40; seed++) {
+        for (config::wasteDifficulty draw : {config::wasteDifficulty::ONE, config::wasteDifficulty::THREE}) {
+            Game *game = Game::createFromSeed(seed, draw);
+            SolveResult result = solver.solve(*game);
+            delete game;
+            if (result.status == SolveStatus::SOLVED) {
+                checkSolution(seed, draw, result);
+            }
+        }
+    }
+
+    for (unsigned threads : {1u, 2u, 4u}) {
+        ParallelSolver parallel(limits(), threads);
+        for (std::minstd_rand::result_type seed = 0; seed < 20; seed++) {
+            Game *game = Game::createFromSeed(seed);
+            SolveResult expected = solver.solve(*game);
+            SolveResult result = parallel.solve(*game);
+            SolveResult again = parallel.solve(*game);
+            delete game;
+            // a search cut short by its node budget may stop anywhere, so only finished ones compare
+            if (finished(expected) && finished(result)) {
+                CHECK_THAT(result.status == expected.status, "seed " << seed << " on " << threads << " threads is "
+                    << solveStatusToString(result.status) << ", not " << solveStatusToString(expected.status));
+                CHECK_THAT(result.solution == expected.solution, "seed " << seed << " on " << threads
+                    << " threads found another line than Solver");
+            }
+            if (finished(result) && finished(again)) {
+                CHECK_THAT(again.status == result.status && again.solution == result.solution, "seed " << seed
+                    << " on " << threads << " threads gave another result when solved again");
+            }
+            if (result.status == SolveStatus::SOLVED) {
+                checkSolution(seed, config::wasteDifficulty::ONE, result);
+            }
+        }
+    }
+    return check::finish("solver");
+}
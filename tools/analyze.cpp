@@ -0,0 +1,343 @@
+/**
+ * @file analyze.cpp
+ * @brief Deals and solves a range of seeds without a window, writing one result per seed.
+ *
+ * Usage: analyze FIRST LAST [options]
+ *   FIRST, LAST      Inclusive range of seeds, dealt exactly as GraphicalGame deals them.
+ *   -j, --threads N  Seeds to solve at once; defaults to one per hardware thread.
+ *   --nodes N        Positions to search per seed before giving up (default 100000, 0 for no limit).
+ *   --time MS        Milliseconds to search per seed before giving up (default 0, no limit).
+ *                    Results stay reproducible only without a time limit.
+ *   --draw N         Cards each turn of the stock pulls, 1 (default) or 3.
+ *   --binary         Write fixed-size binary records instead of CSV.
+ *   -o, --out FILE   Write to FILE instead of stdout.
+ *   --database FILE  Also write a deal database of the range to FILE, see dealdatabase.hpp.
+ *   --tiers N        Difficulty tiers to split the winnable deals of the database into (default 3).
+ *
+ * Results are written in seed order as soon as every earlier seed is done.
+ * The CSV has the columns seed,status,moves,nodes,microseconds; status is one of
+ * solved, unsolvable or unknown, and moves is the length of the winning line found.
+ *
+ * The binary format starts with a 16 byte header: the magic "SLTSEEDS", a u16 version (1),
+ * a u16 record size (16) and 4 reserved bytes. Each record is, little-endian:
+ * u32 seed, u8 status (0 solved, 1 unsolvable, 2 unknown), u8 reserved, u16 moves,
+ * u32 nodes, u32 microseconds; nodes and microseconds saturate at UINT32_MAX.
+ */
+
+#include "dealdatabase.hpp"
+#include "slt.hpp"
+#include "solver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace solitaire;
+
+namespace {
+    using Seed = std::minstd_rand::result_type;
+
+    // seeds handed to a thread at once
+    constexpr std::uint64_t CHUNK_SIZE = 64;
+
+    struct Options {
+        Seed first = 0;
+        Seed last = 0;
+        unsigned threads = 0;
+        SolverLimits limits;
+        config::wasteDifficulty difficulty = config::wasteDifficulty::ONE;
+        bool binary = false;
+        std::string output; // empty for stdout
+        std::string database; // empty for none
+        std::size_t tiers = 3;
+    };
+
+    struct SeedResult {
+        Seed seed;
+        SolveStatus status;
+        std::size_t moves;
+        std::uint64_t nodes;
+        std::chrono::microseconds elapsed;
+    };
+
+    void printUsage(const char *program) {
+        std::cerr << "Usage: " << program << " FIRST LAST [-j N] [--nodes N] [--time MS] [--draw 1|3] [--binary] [-o FILE]"
+            << " [--database FILE] [--tiers N]\n";
+    }
+
+    std::uint64_t parseNumber(const std::string& text, const char *what) {
+        std::size_t parsed = 0;
+        unsigned long long value = 0;
+        try {
+            value = std::stoull(text, &parsed);
+        } catch (const std::exception&) {
+            parsed = 0;
+        }
+        if (parsed == 0 || parsed != text.size()) {
+            throw std::invalid_argument(std::string("Invalid ") + what + ": " + text);
+        }
+        return value;
+    }
+
+    Options parseOptions(int argc, char **argv) {
+        Options options;
+        options.limits.maxNodes = 100'000;
+        options.limits.maxTime = std::chrono::milliseconds(0);
+
+        std::vector<std::string> positional;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "-j" || arg == "--threads") {
+                options.threads = static_cast<unsigned>(parseNumber(value(), "thread count"));
+            } else if (arg == "--nodes") {
+                options.limits.maxNodes = parseNumber(value(), "node limit");
+            } else if (arg == "--time") {
+                options.limits.maxTime = std::chrono::milliseconds(parseNumber(value(), "time limit"));
+            } else if (arg == "--draw") {
+                std::uint64_t draw = parseNumber(value(), "draw count");
+                if (draw != 1 && draw != 3) {
+                    throw std::invalid_argument("The draw count must be 1 or 3");
+                }
+                options.difficulty = draw == 3 ? config::wasteDifficulty::THREE : config::wasteDifficulty::ONE;
+            } else if (arg == "--binary") {
+                options.binary = true;
+            } else if (arg == "-o" || arg == "--out") {
+                options.output = value();
+            } else if (arg == "--database") {
+                options.database = value();
+            } else if (arg == "--tiers") {
+                options.tiers = parseNumber(value(), "tier count");
+                if (options.tiers == 0 || options.tiers > dealdatabase::MAX_TIERS) {
+                    throw std::invalid_argument("The tier count must be from 1 to " + std::to_string(dealdatabase::MAX_TIERS));
+                }
+            } else {
+                positional.push_back(arg);
+            }
+        }
+
+        if (positional.size() != 2) {
+            throw std::invalid_argument("Expected a first and a last seed");
+        }
+        std::uint64_t first = parseNumber(positional[0], "first seed");
+        std::uint64_t last = parseNumber(positional[1], "last seed");
+        if (first > last || last > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("Seeds must form a range within 0 to 4294967295");
+        }
+        options.first = static_cast<Seed>(first);
+        options.last = static_cast<Seed>(last);
+
+        if (options.threads == 0) {
+            options.threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        // a table just large enough for the node limit, so per-seed clearing stays cheap
+        unsigned bits = 24;
+        if (options.limits.maxNodes != 0) {
+            bits = 12;
+            while (bits < 30 && (std::uint64_t(1) << bits) / 4 * 3 <= options.limits.maxNodes) {
+                bits++;
+            }
+        }
+        options.limits.tableBits = bits;
+        return options;
+    }
+
+    std::uint32_t saturate(std::uint64_t value) {
+        return static_cast<std::uint32_t>(std::min<std::uint64_t>(value, std::numeric_limits<std::uint32_t>::max()));
+    }
+
+    void putLittleEndian(char *out, std::uint64_t value, std::size_t bytes) {
+        for (std::size_t i = 0; i < bytes; i++) {
+            out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    void writeHeader(std::ostream& out, bool binary) {
+        if (!binary) {
+            out << "seed,status,moves,nodes,microseconds\n";
+            return;
+        }
+        char header[16] = {};
+        std::memcpy(header, "SLTSEEDS", 8);
+        putLittleEndian(header + 8, 1, 2);
+        putLittleEndian(header + 10, 16, 2);
+        out.write(header, sizeof(header));
+    }
+
+    void writeResult(std::ostream& out, bool binary, const SeedResult& result) {
+        if (!binary) {
+            out << result.seed << ','
+                << solveStatusToString(result.status) << ','
+                << result.moves << ','
+                << result.nodes << ','
+                << result.elapsed.count() << '\n';
+            return;
+        }
+        char record[16] = {};
+        putLittleEndian(record, result.seed, 4);
+        putLittleEndian(record + 4, static_cast<std::uint8_t>(result.status), 1);
+        putLittleEndian(record + 6, std::min<std::size_t>(result.moves, UINT16_MAX), 2);
+        putLittleEndian(record + 8, saturate(result.nodes), 4);
+        putLittleEndian(record + 12, saturate(result.elapsed.count()), 4);
+        out.write(record, sizeof(record));
+    }
+
+    /**
+     * @brief Hands out chunks of seeds to threads and writes their results back in seed order.
+     */
+    class Analysis {
+        const Options& options;
+        std::ostream& out;
+        std::uint64_t chunkCount;
+        std::atomic<std::uint64_t> nextChunk {0};
+
+        std::mutex writeMutex;
+        std::uint64_t nextToWrite = 0;
+        std::map<std::uint64_t, std::vector<SeedResult>> finished; // done but waiting for earlier chunks
+        std::uint64_t counts[3] = {};
+        std::vector<DealDatabase::Deal> deals; // in seed order, when writing a database
+
+        void finish(std::uint64_t chunk, std::vector<SeedResult>&& results) {
+            std::lock_guard<std::mutex> lock(this->writeMutex);
+            this->finished.emplace(chunk, std::move(results));
+            while (!this->finished.empty() && this->finished.begin()->first == this->nextToWrite) {
+                for (const SeedResult& result : this->finished.begin()->second) {
+                    writeResult(this->out, this->options.binary, result);
+                    this->counts[static_cast<int>(result.status)]++;
+                    if (!this->options.database.empty()) {
+                        this->deals.push_back({
+                            result.status,
+                            dealdatabase::NO_TIER,
+                            static_cast<std::uint16_t>(std::min<std::size_t>(result.moves, UINT16_MAX)),
+                            saturate(result.nodes)
+                        });
+                    }
+                }
+                this->finished.erase(this->finished.begin());
+                this->nextToWrite++;
+            }
+        }
+
+    public:
+        Analysis(const Options& options, std::ostream& out):
+            options(options),
+            out(out),
+            chunkCount((std::uint64_t(options.last) - options.first) / CHUNK_SIZE + 1) {}
+
+        void work() {
+            Solver solver(this->options.limits);
+            std::vector<SeedResult> results;
+            std::uint64_t chunk;
+            while ((chunk = this->nextChunk.fetch_add(1, std::memory_order_relaxed)) < this->chunkCount) {
+                std::uint64_t first = this->options.first + chunk * CHUNK_SIZE;
+                std::uint64_t last = std::min<std::uint64_t>(first + CHUNK_SIZE - 1, this->options.last);
+
+                results.clear();
+                for (std::uint64_t seed = first; seed <= last; seed++) {
+                    std::unique_ptr<Game> game(Game::createFromSeed(static_cast<Seed>(seed), this->options.difficulty));
+                    SolveResult solved = solver.solve(*game);
+                    results.push_back({
+                        static_cast<Seed>(seed),
+                        solved.status,
+                        solved.solution.size(),
+                        solved.nodes,
+                        solved.elapsed
+                    });
+                }
+                this->finish(chunk, std::move(results));
+                results = std::vector<SeedResult>();
+                results.reserve(CHUNK_SIZE);
+            }
+        }
+
+        /// @brief Gets how many seeds ended with each SolveStatus.
+        const std::uint64_t *statusCounts() const {
+            return this->counts;
+        }
+
+        /// @brief Gets what solving each seed found, in seed order, if writing a database.
+        const std::vector<DealDatabase::Deal>& solvedDeals() const {
+            return this->deals;
+        }
+    };
+}
+
+int main(int argc, char **argv) {
+    std::ios::sync_with_stdio(false);
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output, options.binary ? std::ios::out | std::ios::binary : std::ios::out);
+        if (!file) {
+            std::cerr << "Cannot open " << options.output << '\n';
+            return 1;
+        }
+    }
+    std::ostream& out = options.output.empty() ? std::cout : file;
+
+    auto began = std::chrono::steady_clock::now();
+    writeHeader(out, options.binary);
+    Analysis analysis(options, out);
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < options.threads; i++) {
+        threads.emplace_back(&Analysis::work, &analysis);
+    }
+    analysis.work();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    out.flush();
+
+    if (!options.database.empty()) {
+        try {
+            DealDatabase::write(
+                options.database,
+                options.difficulty == config::wasteDifficulty::THREE ? 3 : 1,
+                options.first,
+                analysis.solvedDeals(),
+                options.tiers,
+                saturate(options.limits.maxNodes)
+            );
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+    std::uint64_t total = std::uint64_t(options.last) - options.first + 1;
+    const std::uint64_t *counts = analysis.statusCounts();
+    std::cerr << total << " seeds in " << seconds << " s ("
+        << total / std::max(seconds, 1e-9) << " seeds/s): "
+        << counts[static_cast<int>(SolveStatus::SOLVED)] << " solved, "
+        << counts[static_cast<int>(SolveStatus::UNSOLVABLE)] << " unsolvable, "
+        << counts[static_cast<int>(SolveStatus::UNKNOWN)] << " unknown\n";
+    return out ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file packassets.cpp
+ * @brief Decodes every card image once and writes them as a single asset pack the game can map at startup.
+ *
+ * Usage: packassets [IMAGES_DIR] [-o FILE]
+ *   IMAGES_DIR       Where to find the images, assets/images by default. Every .png below it
+ *                    is packed, named after its path relative to it without the extension.
+ *   -o, --out FILE   Where to write the pack, assets/cards.pack by default.
+ *
+ * The images are laid out on a grid in the atlas, in name order, each in a cell as large as the
+ * largest image. See assetpack.hpp for the file format. Unlike the engine tools, this one decodes
+ * PNGs through raylib, so it is built with `make assets` where raylib is available.
+ */
+
+#include "assetpack.hpp"
+
+#include <raylib.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace solitaire;
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr std::size_t COLUMNS = 13;
+
+    struct Options {
+        std::string images = "assets/images";
+        std::string output = "assets/cards.pack";
+    };
+
+    struct PackedImage {
+        std::string name;
+        Image image;
+        AssetPack::Region region;
+    };
+
+    void printUsage(const char *program) {
+        std::cerr << "Usage: " << program << " [IMAGES_DIR] [-o FILE]\n";
+    }
+
+    Options parseOptions(int argc, char **argv) {
+        Options options;
+        bool hasImages = false;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "-o" || arg == "--out") {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing value for " + arg);
+                }
+                options.output = argv[++i];
+            } else if (!hasImages) {
+                options.images = arg;
+                hasImages = true;
+            } else {
+                throw std::invalid_argument("Unexpected argument " + arg);
+            }
+        }
+        return options;
+    }
+
+    void putLittleEndian(char *out, std::uint64_t value, std::size_t bytes) {
+        for (std::size_t i = 0; i < bytes; i++) {
+            out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    std::vector<PackedImage> loadImages(const fs::path& root) {
+        std::vector<PackedImage> images;
+        for (const fs::directory_entry& entry : fs::recursive_directory_iterator(root)) {
+            if (!entry.is_regular_file() || entry.path().extension() != ".png") continue;
+
+            std::string name = entry.path().lexically_relative(root).replace_extension().generic_string();
+            if (name.size() >= assetpack::NAME_SIZE) {
+                throw std::runtime_error("Image name too long for the pack: " + name);
+            }
+            Image image = LoadImage(entry.path().string().c_str());
+            if (image.data == nullptr) {
+                throw std::runtime_error("Cannot decode " + entry.path().string());
+            }
+            ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            images.push_back({name, image, {}});
+        }
+        std::sort(images.begin(), images.end(), [](const PackedImage& a, const PackedImage& b) {
+            return a.name < b.name;
+        });
+        return images;
+    }
+
+    void writePack(const std::string& path, const std::vector<PackedImage>& images, const Image& atlas) {
+        using namespace assetpack;
+        std::size_t indexEnd = HEADER_SIZE + images.size() * ENTRY_SIZE;
+        std::size_t pixelsOffset = (indexEnd + PIXELS_ALIGNMENT - 1) / PIXELS_ALIGNMENT * PIXELS_ALIGNMENT;
+
+        std::vector<char> head(pixelsOffset, 0);
+        std::copy(std::begin(MAGIC), std::end(MAGIC), head.begin());
+        putLittleEndian(&head[8], VERSION, 2);
+        putLittleEndian(&head[10], images.size(), 2);
+        putLittleEndian(&head[12], atlas.width, 4);
+        putLittleEndian(&head[16], atlas.height, 4);
+        putLittleEndian(&head[20], pixelsOffset, 4);
+        for (std::size_t i = 0; i < images.size(); i++) {
+            char *entry = &head[HEADER_SIZE + i * ENTRY_SIZE];
+            const PackedImage& packed = images[i];
+            std::copy(packed.name.begin(), packed.name.end(), entry);
+            putLittleEndian(entry + NAME_SIZE, packed.region.x, 4);
+            putLittleEndian(entry + NAME_SIZE + 4, packed.region.y, 4);
+            putLittleEndian(entry + NAME_SIZE + 8, packed.region.width, 4);
+            putLittleEndian(entry + NAME_SIZE + 12, packed.region.height, 4);
+        }
+
+        std::ofstream out(path, std::ios::out | std::ios::binary);
+        out.write(head.data(), head.size());
+        out.write(static_cast<const char *>(atlas.data), std::size_t(atlas.width) * atlas.height * BYTES_PER_PIXEL);
+        if (!out) {
+            throw std::runtime_error("Cannot write " + path);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    try {
+        std::vector<PackedImage> images = loadImages(options.images);
+        if (images.empty()) {
+            throw std::runtime_error("No images found in " + options.images);
+        }
+        int cellWidth = 0;
+        int cellHeight = 0;
+        for (const PackedImage& packed : images) {
+            cellWidth = std::max(cellWidth, packed.image.width);
+            cellHeight = std::max(cellHeight, packed.image.height);
+        }
+
+        std::size_t rows = (images.size() + COLUMNS - 1) / COLUMNS;
+        Image atlas = GenImageColor(COLUMNS * cellWidth, rows * cellHeight, BLANK);
+        for (std::size_t i = 0; i < images.size(); i++) {
+            PackedImage& packed = images[i];
+            packed.region = {
+                static_cast<std::uint32_t>(i % COLUMNS * cellWidth),
+                static_cast<std::uint32_t>(i / COLUMNS * cellHeight),
+                static_cast<std::uint32_t>(packed.image.width),
+                static_cast<std::uint32_t>(packed.image.height)
+            };
+            Rectangle source = {0, 0, static_cast<float>(packed.image.width), static_cast<float>(packed.image.height)};
+            Rectangle dest = {
+                static_cast<float>(packed.region.x),
+                static_cast<float>(packed.region.y),
+                source.width,
+                source.height
+            };
+            ImageDraw(&atlas, packed.image, source, dest, WHITE);
+            UnloadImage(packed.image);
+        }
+
+        writePack(options.output, images, atlas);
+        std::cerr << "Packed " << images.size() << " images into a " << atlas.width << 'x' << atlas.height
+            << " atlas in " << options.output << '\n';
+        UnloadImage(atlas);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}